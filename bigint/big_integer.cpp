@@ -5,13 +5,44 @@
 #include <algorithm>
 #include <utility>
 #include <climits>
+#include <cmath>
 
 using data_storage = big_integer::data_storage;
-
-template<typename T>
-using binary_operation = big_integer::binary_operation<T>;
-
-static uint64_t const BASE64 = 0x100000000ULL;
+using word_t = big_integer::word_t;
+#if BIG_INTEGER_WORD_BITS == 64
+using dword_t = __uint128_t;
+#else
+using dword_t = uint64_t;
+#endif
+
+static size_t const WORD_BITS = BIG_INTEGER_WORD_BITS;
+static dword_t const BASE = static_cast<dword_t>(1) << WORD_BITS;
+
+#if BIG_INTEGER_WORD_BITS == 64
+static size_t const KARATSUBA_THRESHOLD = 24;
+static size_t const TOOM3_THRESHOLD = 200;
+static size_t const NTT_THRESHOLD = 2500;
+static size_t const DIV_DC_THRESHOLD = 60;
+static size_t const NEWTON_DIV_THRESHOLD = 10000;
+static size_t const TO_STRING_THRESHOLD = 60;
+static size_t const HGCD_THRESHOLD = 100;
+
+static word_t const DECIMAL_BASE = 10000000000000000000ULL;
+static size_t const DECIMAL_DIGITS = 19;
+#else
+static size_t const KARATSUBA_THRESHOLD = 32;
+static size_t const TOOM3_THRESHOLD = 150;
+static size_t const NTT_THRESHOLD = 5000;
+static size_t const DIV_DC_THRESHOLD = 80;
+static size_t const NEWTON_DIV_THRESHOLD = 20000;
+static size_t const TO_STRING_THRESHOLD = 60;
+static size_t const HGCD_THRESHOLD = 150;
+
+static word_t const DECIMAL_BASE = 1000000000;
+static size_t const DECIMAL_DIGITS = 9;
+#endif
+static size_t const FROM_STRING_THRESHOLD = 1000;
+static size_t const RECIPROCAL_THRESHOLD = 2 * DIV_DC_THRESHOLD;
 
 big_integer::big_integer(int32_t sign, data_storage const& other_data) : data(other_data), sign(sign) {}
 
@@ -19,13 +50,18 @@ big_integer::big_integer() : sign(0) {}
 
 big_integer::big_integer(big_integer const& other) = default;
 
+big_integer::big_integer(big_integer&& other) noexcept : data(std::move(other.data)), sign(other.sign) {
+    other.data.clear();
+    other.sign = 0;
+}
+
 big_integer::big_integer(data_storage const& other) : big_integer(1, other) {}
 
 big_integer::big_integer(int a) {
     if (a != 0) {
         sign = a < 0 ? -1 : 1;
         if (a == INT_MIN) {
-            data.push_back(static_cast<uint32_t>(INT_MAX) + 1);
+            data.push_back(static_cast<word_t>(INT_MAX) + 1);
         } else {
             data.push_back(std::abs(a));
         }
@@ -34,12 +70,15 @@ big_integer::big_integer(int a) {
     }
 }
 
-big_integer::big_integer(uint32_t a) : sign(a != 0) {
+big_integer::big_integer(word_t a) : sign(a != 0) {
     if (a != 0) {
         data.push_back(a);
     }
 }
 
+#if BIG_INTEGER_WORD_BITS == 64
+big_integer::big_integer(uint32_t a) : big_integer(static_cast<word_t>(a)) {}
+#endif
 
 big_integer::big_integer(std::string const& str) : big_integer() {
     size_t len = str.size();
@@ -47,7 +86,7 @@ big_integer::big_integer(std::string const& str) : big_integer() {
         throw std::runtime_error("Invalid string");
     }
     size_t ptr = 0;
-    while (str[0] == ' ') {
+    while (ptr < len && str[ptr] == ' ') {
         ++ptr;
     }
     int32_t signum = 1;
@@ -57,508 +96,2859 @@ big_integer::big_integer(std::string const& str) : big_integer() {
     } else if (str[ptr] == '+') {
         ++ptr;
     }
+    if (ptr == len || !isdigit(str[ptr])) {
+        throw std::runtime_error("Invalid string");
+    }
     while (str[ptr] == '0') {
         ptr++;
     }
-    *this = 0;
-    if (ptr == len) {
-        signum = 0;
-    } else {
-        while (ptr < len) {
-            if (!isdigit(str[ptr])) {
-                throw std::runtime_error("Invalid string");
-            }
-            *this *= 10;
-            *this += static_cast<int>(str[ptr] - '0');
-            ++ptr;
+    for (size_t i = ptr; i < len; ++i) {
+        if (!isdigit(str[i])) {
+            throw std::runtime_error("Invalid string");
         }
     }
-    sign = signum;
+    size_t digits = len - ptr;
+    if (digits != 0) {
+        std::vector<big_integer> powers;
+        if (digits > FROM_STRING_THRESHOLD) {
+            powers = decimal_powers(digits);
+        }
+        *this = from_decimal(str.data() + ptr, digits, powers, powers.size());
+        sign = signum;
+    }
 }
 
 size_t big_integer::size() const {
     return data.size();
 }
 
-static uint32_t lowest_8_bytes(uint64_t value) {
-    return static_cast<uint32_t>(value & (BASE64 - 1));
-}
-
-static uint64_t get_data64(data_storage const& data, size_t id) {
-    return data[id];
+static word_t low_word(dword_t value) {
+    return static_cast<word_t>(value);
 }
 
-static int32_t compare_abs(data_storage const& words, data_storage const& other_words) {
-    if (words.size() == other_words.size()) {
-        size_t ptr = 0;
-        while (ptr < words.size() && words[ptr] == other_words[ptr]) {
-            ptr++;
+static int32_t compare_abs(word_t const* words, size_t n, word_t const* other_words, size_t m) {
+    if (n == m) {
+        size_t ptr = n;
+        while (ptr > 0 && words[ptr - 1] == other_words[ptr - 1]) {
+            ptr--;
         }
-        if (ptr == words.size()) {
+        if (ptr == 0) {
             return 0;
         }
-        return (words[ptr] < other_words[ptr])? -1 : 1;
+        return (words[ptr - 1] < other_words[ptr - 1])? -1 : 1;
     }
-    return (words.size() < other_words.size())? -1 : 1;
+    return (n < m)? -1 : 1;
 }
 
-static uint32_t get_word(data_storage const& val, size_t n) {
-    if (n >= val.size()) {
-        return 0;
-    }
-    return val[val.size() - n - 1];
+static int32_t compare_abs(data_storage const& words, data_storage const& other_words) {
+    return compare_abs(words.data(), words.size(), other_words.data(), other_words.size());
 }
 
-static void remove_zeroes(data_storage& v) {
-    if (v.empty()) {
-        return;
+// Compares |words| with a value of at most 64 / WORD_BITS words, without building its words
+static int32_t compare_abs(data_storage const& words, uint64_t value) {
+    if (words.size() * WORD_BITS > 64) {
+        return 1;
     }
-    size_t ptr = 0;
-    while (ptr < v.size() && v[ptr] == 0) {
-        ptr++;
+    uint64_t x = 0;
+    for (size_t i = words.size(); i > 0; --i) {
+        x = static_cast<uint64_t>(static_cast<dword_t>(x) << WORD_BITS) | words[i - 1];
     }
-    if (ptr == v.size()) {
-        v.resize(0);
-        return;
+    if (x == value) {
+        return 0;
+    }
+    return (x < value)? -1 : 1;
+}
+
+// Splits a machine word into its at most 64 / WORD_BITS limbs, returns their count
+static size_t split_words(word_t* words, uint64_t value) {
+    size_t n = 0;
+    while (value != 0) {
+        words[n++] = static_cast<word_t>(value);
+        value = static_cast<uint64_t>(static_cast<dword_t>(value) >> WORD_BITS);
     }
-    v.resize(std::move(v.begin() + ptr, v.end(), v.begin()) - v.begin());
+    return n;
 }
 
-static uint64_t add(uint32_t a, uint32_t b) {
-    return static_cast<uint64_t>(a) + b;
+static uint64_t magnitude_of(int64_t value) {
+    return (value < 0)? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
 }
 
-static uint64_t sub(uint32_t a, uint32_t b) {
-    return static_cast<uint64_t>(a) - b;
+static int32_t sign_of(int64_t value) {
+    return (value > 0) - (value < 0);
 }
 
-static void apply_arithmetic_long(data_storage& a, data_storage const& b,
-                                  size_t begin, size_t end, binary_operation<uint64_t> const& op) {
-    int32_t carry = 0;
-    for (size_t i = begin; i < end; ++i) {
-        uint64_t swc = op(get_word(a, i), get_word(b, i - begin)) + carry;
-        a[a.size() - i - 1] = lowest_8_bytes(swc);
-        carry = (swc >> 32ULL);
+static void remove_zeroes(data_storage& v) {
+    while (!v.empty() && v.back() == 0) {
+        v.pop_back();
     }
 }
 
-static data_storage apply_binary_long(data_storage const& a, data_storage const &b,
-                                      binary_operation<uint64_t> const& op) {
-    data_storage res(std::max(a.size(), b.size()) + 1, 0);
-    std::move(a.begin(), a.end(), res.end() - a.size());
-    apply_arithmetic_long(res, b, 0, res.size(), op);
-    remove_zeroes(res);
-    return res;
+static void increment_abs(data_storage& v) {
+    size_t i = 0;
+    while (i < v.size() && ++v[i] == 0) {
+        ++i;
+    }
+    if (i == v.size()) {
+        v.push_back(1);
+    }
 }
 
-static data_storage apply_add_long(data_storage const& a, data_storage const &b) {
-    return apply_binary_long(a, b, add);
+// v must be non-zero
+static void decrement_abs(data_storage& v) {
+    size_t i = 0;
+    while (v[i]-- == 0) {
+        ++i;
+    }
+    remove_zeroes(v);
+}
+
+static word_t add_span(word_t* a, size_t n, word_t const* b, size_t m) {
+    dword_t carry = 0;
+    size_t i = 0;
+    for (; i < m; ++i) {
+        carry += static_cast<dword_t>(a[i]) + b[i];
+        a[i] = static_cast<word_t>(carry);
+        carry >>= WORD_BITS;
+    }
+    for (; carry != 0 && i < n; ++i) {
+        carry += a[i];
+        a[i] = static_cast<word_t>(carry);
+        carry >>= WORD_BITS;
+    }
+    return static_cast<word_t>(carry);
 }
 
-static data_storage apply_subtract_long(data_storage const& a, data_storage const &b) {
-    return apply_binary_long(a, b, sub);
+static word_t sub_span(word_t* a, size_t n, word_t const* b, size_t m) {
+    dword_t borrow = 0;
+    size_t i = 0;
+    for (; i < m; ++i) {
+        dword_t cur = static_cast<dword_t>(a[i]) - b[i] - borrow;
+        a[i] = static_cast<word_t>(cur);
+        borrow = (cur >> WORD_BITS) & 1U;
+    }
+    for (; borrow != 0 && i < n; ++i) {
+        borrow = (a[i] == 0);
+        --a[i];
+    }
+    return static_cast<word_t>(borrow);
 }
 
-static void short_mul(data_storage &a, uint32_t rhs) {
-    uint32_t carry = 0;
-    for (size_t i = 0; i < a.size(); ++i) {
-        uint64_t swc = static_cast<uint64_t>(get_word(a, i)) * rhs + carry;
-        a[a.size() - i - 1] = lowest_8_bytes(swc);
-        carry = (swc >> 32ULL);
+// a = b - a, where a has n <= m limbs of room for m and does not exceed b
+static void rsub_span(word_t* a, size_t n, word_t const* b, size_t m) {
+    dword_t borrow = 0;
+    size_t i = 0;
+    for (; i < n; ++i) {
+        dword_t cur = static_cast<dword_t>(b[i]) - a[i] - borrow;
+        a[i] = static_cast<word_t>(cur);
+        borrow = (cur >> WORD_BITS) & 1U;
     }
-    if (carry) {
-        a.insert(a.begin(), carry);
+    for (; i < m; ++i) {
+        dword_t cur = static_cast<dword_t>(b[i]) - borrow;
+        a[i] = static_cast<word_t>(cur);
+        borrow = (cur >> WORD_BITS) & 1U;
     }
 }
 
-big_integer& big_integer::add_signed(int32_t rhs_sign, data_storage const& rhs_words) {
-    data_storage new_data = data;
+// rhs_words may be the words of *this, which are not reallocated before they are read
+big_integer& big_integer::add_signed(int32_t rhs_sign, word_t const* rhs_words, size_t n) {
     if (rhs_sign == 0) {
         return *this;
-    } else if (sign == 0) {
+    }
+    if (sign == 0) {
         sign = rhs_sign;
-        new_data = rhs_words;
-    } else if (sign == rhs_sign) {
-        new_data = apply_add_long(new_data, rhs_words);
-    } else {
-        int32_t cmp = compare_abs(new_data, rhs_words);
-        if (cmp == 0) {
-            new_data.clear();
-            sign = 0;
-        } else {
-            new_data = (cmp > 0 ? apply_subtract_long(new_data, rhs_words) : apply_subtract_long(rhs_words, new_data));
-            sign = (sign == cmp? 1 : -1);
+        data.assign(rhs_words, rhs_words + n);
+        return *this;
+    }
+    if (sign == rhs_sign) {
+        if (data.size() < n) {
+            data.resize(n);
         }
+        if (add_span(data.data(), data.size(), rhs_words, n)) {
+            data.push_back(1);
+        }
+        return *this;
+    }
+    int32_t cmp = compare_abs(data.data(), data.size(), rhs_words, n);
+    if (cmp == 0) {
+        data.clear();
+        sign = 0;
+        return *this;
+    }
+    if (cmp > 0) {
+        sub_span(data.data(), data.size(), rhs_words, n);
+    } else {
+        size_t m = data.size();
+        data.resize(n);
+        rsub_span(data.data(), m, rhs_words, n);
+        sign = rhs_sign;
     }
-    data = new_data;
+    remove_zeroes(data);
     return *this;
 }
 
 big_integer& big_integer::operator+=(big_integer const& rhs) {
-    return add_signed(rhs.sign, rhs.data);
+    return add_signed(rhs.sign, rhs.data.data(), rhs.size());
 }
 
 big_integer& big_integer::operator-=(big_integer const& rhs) {
-    return add_signed(-rhs.sign, rhs.data);
+    return add_signed(-rhs.sign, rhs.data.data(), rhs.size());
 }
 
-big_integer& big_integer::operator*=(big_integer const& rhs) {
-    if (sign != 0U && rhs.sign == 0U) {
-        *this = 0U;
-    }
-    if (sign == 0U) {
-        return *this;
-    }
+big_integer& big_integer::operator+=(int64_t rhs) {
+    word_t words[64 / WORD_BITS];
+    return add_signed(sign_of(rhs), words, split_words(words, magnitude_of(rhs)));
+}
 
-    data_storage other_data(rhs.data);
-    data.insert(data.begin(), 0U);
-    data_storage res(data.size() + other_data.size(), 0U);
+big_integer& big_integer::operator+=(uint64_t rhs) {
+    word_t words[64 / WORD_BITS];
+    return add_signed(rhs != 0, words, split_words(words, rhs));
+}
 
-    for (size_t i = 0; i < other_data.size(); i++) {
-        data_storage tmp(data);
-        short_mul(tmp, other_data[other_data.size() - i - 1]);
-        apply_arithmetic_long(res, tmp, i, tmp.size() + i, add);
-    }
+big_integer& big_integer::operator+=(int rhs) {
+    return (*this += static_cast<int64_t>(rhs));
+}
 
-    remove_zeroes(res);
-    return (*this = big_integer(sign * rhs.sign, res));
+big_integer& big_integer::operator+=(uint32_t rhs) {
+    return (*this += static_cast<uint64_t>(rhs));
 }
 
-static void short_div(data_storage& data, uint32_t rhs) {
-    uint64_t rest = 0;
-    for (uint32_t& i : data) {
-        uint64_t x = (rest << 32ULL) | i;
-        i = lowest_8_bytes(x / rhs);
-        rest = x % rhs;
-    }
-    remove_zeroes(data);
+big_integer& big_integer::operator-=(int64_t rhs) {
+    word_t words[64 / WORD_BITS];
+    return add_signed(-sign_of(rhs), words, split_words(words, magnitude_of(rhs)));
 }
 
-static bool smaller(data_storage const &a, size_t start, data_storage const &b, size_t prefix) {
-    size_t i = 0;
-    while (i < prefix && a[i + start] == get_word(b, prefix - i - 1)) {
-        ++i;
-    }
-    return i < prefix && a[i + start] < get_word(b, prefix - i - 1);
+big_integer& big_integer::operator-=(uint64_t rhs) {
+    word_t words[64 / WORD_BITS];
+    return add_signed(-static_cast<int32_t>(rhs != 0), words, split_words(words, rhs));
 }
 
-static void difference(data_storage& a, size_t st, data_storage const& b, size_t prefix) {
-    if (a.size() - st < prefix) {
-        return;
-    }
-    apply_arithmetic_long(a, b, a.size() - st - prefix, a.size() - st, sub);
+big_integer& big_integer::operator-=(int rhs) {
+    return (*this -= static_cast<int64_t>(rhs));
 }
 
-static __uint128_t get_word128(data_storage const& data, size_t i) {
-    return get_word(data, i);
+big_integer& big_integer::operator-=(uint32_t rhs) {
+    return (*this -= static_cast<uint64_t>(rhs));
 }
 
-static __uint128_t build128(data_storage const& data, size_t size, size_t start) {
-    __uint128_t res = 0;
-    for (size_t i = start; i < size + start; ++i) {
-        res += get_word128(data, data.size() - i - 1) << ((size - 1ULL - i + start) * 32ULL);
+static bool abs_diff(word_t* res, word_t const* a, size_t n, word_t const* b, size_t m) {
+    bool less = false;
+    size_t i = n;
+    while (i > m && a[i - 1] == 0) {
+        --i;
     }
-    return res;
+    if (i == m) {
+        while (i > 0 && a[i - 1] == b[i - 1]) {
+            --i;
+        }
+        less = (i > 0 && a[i - 1] < b[i - 1]);
+    }
+    if (less) {
+        std::copy(b, b + m, res);
+        std::fill(res + m, res + n, 0U);
+        sub_span(res, n, a, m);
+    } else {
+        std::copy(a, a + n, res);
+        sub_span(res, n, b, m);
+    }
+    return less;
 }
 
-big_integer& big_integer::operator/=(big_integer const &other) {
-    if (compare_abs(data, other.data) < 0) {
-        return (*this = 0);
+static void mul_basecase(word_t* res, word_t const* a, size_t n, word_t const* b, size_t m) {
+    std::fill(res, res + n, 0U);
+    for (size_t j = 0; j < m; ++j) {
+        dword_t carry = 0;
+        for (size_t i = 0; i < n; ++i) {
+            carry += static_cast<dword_t>(a[i]) * b[j] + res[i + j];
+            res[i + j] = static_cast<word_t>(carry);
+            carry >>= WORD_BITS;
+        }
+        res[n + j] = static_cast<word_t>(carry);
     }
+}
 
-    sign *= other.sign;
-
-    if (other.size() == 1) {
-        short_div(data, other.data[0]);
-        return *this;
+// a[0, n) += b[0, n) * c, returns the carry out of a[n - 1]
+static word_t addmul_1(word_t* a, word_t const* b, size_t n, word_t c) {
+    dword_t carry = 0;
+    for (size_t i = 0; i < n; ++i) {
+        carry += static_cast<dword_t>(b[i]) * c + a[i];
+        a[i] = static_cast<word_t>(carry);
+        carry >>= WORD_BITS;
     }
+    return static_cast<word_t>(carry);
+}
 
-    data_storage this_abs(data);
-    data_storage other_abs(other.data);
-
-    uint32_t f = lowest_8_bytes(BASE64
-                                / (get_data64(other_abs, 0) + 1));
-    short_mul(this_abs, f);
-    short_mul(other_abs, f);
-
-    this_abs.insert(this_abs.begin(), 0);
-    size_t m = other_abs.size() + 1;
-    size_t n = this_abs.size();
-    data.resize(n - m + 1);
-
-    for (size_t i = m, j = 0; i <= n; ++i, ++j) {
-        __uint128_t x = build128(this_abs, 3, j);
-        __uint128_t y = build128(other_abs, 2, 0);
-
-        uint32_t qt = lowest_8_bytes(std::min(static_cast<uint64_t>(x / y), BASE64 - 1));
-        data_storage dq(other_abs);
-        short_mul(dq, qt);
-
-        if (smaller(this_abs, j, dq, m)) {
-            qt--;
-            apply_subtract_long(dq, other_abs);
+// res[0, n) = a[0, n) * c, returns the carry out of res[n - 1]; res may alias a
+static word_t mul_1(word_t* res, word_t const* a, size_t n, word_t c) {
+    dword_t carry = 0;
+    for (size_t i = 0; i < n; ++i) {
+        carry += static_cast<dword_t>(a[i]) * c;
+        res[i] = static_cast<word_t>(carry);
+        carry >>= WORD_BITS;
+    }
+    return static_cast<word_t>(carry);
+}
+
+static void sqr_basecase(word_t* res, word_t const* a, size_t n) {
+    std::fill(res, res + n, 0U);
+    res[n] = 0;
+    for (size_t i = 0; i + 1 < n; ++i) {
+        dword_t carry = 0;
+        for (size_t j = i + 1; j < n; ++j) {
+            carry += static_cast<dword_t>(a[i]) * a[j] + res[i + j];
+            res[i + j] = static_cast<word_t>(carry);
+            carry >>= WORD_BITS;
         }
+        res[i + n] = static_cast<word_t>(carry);
+    }
+    res[2 * n - 1] = 0;
+    add_span(res, 2 * n, res, 2 * n);
+
+    dword_t carry = 0;
+    for (size_t i = 0; i < n; ++i) {
+        dword_t square = static_cast<dword_t>(a[i]) * a[i];
+        carry += static_cast<dword_t>(res[2 * i]) + static_cast<word_t>(square);
+        res[2 * i] = static_cast<word_t>(carry);
+        carry >>= WORD_BITS;
+        carry += static_cast<dword_t>(res[2 * i + 1]) + (square >> WORD_BITS);
+        res[2 * i + 1] = static_cast<word_t>(carry);
+        carry >>= WORD_BITS;
+    }
+}
 
-        data[j] = qt;
-        difference(this_abs, j, dq, m);
+static size_t karatsuba_scratch(size_t n) {
+    size_t total = 0;
+    while (n > KARATSUBA_THRESHOLD) {
+        n = (n + 1) / 2;
+        total += 4 * n + 1;
     }
+    return total;
+}
 
-    remove_zeroes(data);
-    return *this;
+static size_t mul_scratch(size_t n) {
+    if (n <= TOOM3_THRESHOLD) {
+        return karatsuba_scratch(n);
+    }
+    size_t k = (n + 2) / 3;
+    return 10 * k + 10 + mul_scratch(k + 1);
 }
 
-big_integer& big_integer::operator%=(big_integer const& rhs) {
-    *this -= (*this / rhs) * rhs;
-    return *this;
+// res[0, 2n) = a[0, n) * b[0, n), scratch holds karatsuba_scratch(n) limbs
+static void mul_karatsuba(word_t* res, word_t const* a, word_t const* b, size_t n, word_t* scratch) {
+    if (n <= KARATSUBA_THRESHOLD) {
+        mul_basecase(res, a, n, b, n);
+        return;
+    }
+    size_t h = (n + 1) / 2;
+    size_t l = n - h;
+    word_t* mid = scratch;
+    word_t* da = scratch;
+    word_t* db = scratch + h;
+    word_t* prod = scratch + 2 * h + 1;
+    word_t* next = prod + 2 * h;
+
+    mul_karatsuba(res, a, b, h, next);
+    mul_karatsuba(res + 2 * h, a + h, b + h, l, next);
+    bool negative = abs_diff(da, a, h, a + h, l) != abs_diff(db, b, h, b + h, l);
+    mul_karatsuba(prod, da, db, h, next);
+
+    std::copy(res, res + 2 * h, mid);
+    mid[2 * h] = 0;
+    add_span(mid, 2 * h + 1, res + 2 * h, 2 * l);
+    if (negative) {
+        add_span(mid, 2 * h + 1, prod, 2 * h);
+    } else {
+        sub_span(mid, 2 * h + 1, prod, 2 * h);
+    }
+    add_span(res + h, 2 * n - h, mid, std::min(2 * h + 1, 2 * n - h));
 }
 
-static size_t not_zero_id(data_storage const& value) {
-    for (size_t i = value.size(); i > 0; --i) {
-        if (value[i - 1] != 0) {
-            return value.size() - i;
-        }
+// res[0, 2n) = a[0, n) ^ 2, scratch holds karatsuba_scratch(n) limbs
+static void sqr_karatsuba(word_t* res, word_t const* a, size_t n, word_t* scratch) {
+    if (n <= KARATSUBA_THRESHOLD) {
+        sqr_basecase(res, a, n);
+        return;
+    }
+    size_t h = (n + 1) / 2;
+    size_t l = n - h;
+    word_t* mid = scratch;
+    word_t* da = scratch;
+    word_t* prod = scratch + 2 * h + 1;
+    word_t* next = prod + 2 * h;
+
+    sqr_karatsuba(res, a, h, next);
+    sqr_karatsuba(res + 2 * h, a + h, l, next);
+    abs_diff(da, a, h, a + h, l);
+    sqr_karatsuba(prod, da, h, next);
+
+    std::copy(res, res + 2 * h, mid);
+    mid[2 * h] = 0;
+    add_span(mid, 2 * h + 1, res + 2 * h, 2 * l);
+    sub_span(mid, 2 * h + 1, prod, 2 * h);
+    add_span(res + h, 2 * n - h, mid, std::min(2 * h + 1, 2 * n - h));
+}
+
+static void negate_span(word_t* a, size_t n) {
+    dword_t carry = 1;
+    for (size_t i = 0; i < n; ++i) {
+        carry += static_cast<word_t>(~a[i]);
+        a[i] = static_cast<word_t>(carry);
+        carry >>= WORD_BITS;
     }
-    return value.size();
 }
 
-uint32_t big_integer::get_signed(size_t id, size_t not_zero_pos) const {
-    if (sign == 0) {
-        return 0;
+static bool abs_signed(word_t* a, size_t n) {
+    if (a[n - 1] >> (WORD_BITS - 1)) {
+        negate_span(a, n);
+        return true;
     }
-    if (id > data.size()) {
-        return sign == 1? 0 : -1;
-    } else if (id == data.size()) {
-        uint32_t word = 0;
-        return sign == 1? word : (id <= not_zero_pos? -word : ~word);
-    } else {
-        uint32_t word = data[data.size() - id - 1];
-        return sign == 1? word : (id <= not_zero_pos? -word : ~word);
+    return false;
+}
+
+static void shr1_signed(word_t* a, size_t n) {
+    for (size_t i = 0; i + 1 < n; ++i) {
+        a[i] = (a[i] >> 1U) | (a[i + 1] << (WORD_BITS - 1));
+    }
+    a[n - 1] = (a[n - 1] >> 1U) | (a[n - 1] & (static_cast<word_t>(1) << (WORD_BITS - 1)));
+}
+
+static void divexact_by3(word_t* a, size_t n) {
+    word_t const inverse = ~static_cast<word_t>(0) / 3 * 2 + 1;
+    word_t borrow = 0;
+    for (size_t i = 0; i < n; ++i) {
+        word_t s = a[i];
+        word_t l = s - borrow;
+        borrow = (l > s);
+        word_t q = l * inverse;
+        a[i] = q;
+        borrow += static_cast<word_t>((static_cast<dword_t>(q) * 3U) >> WORD_BITS);
     }
 }
 
-static big_integer get_value(data_storage& value) {
-    if (!value.empty() && value[0] >> 31u) {
-        for (uint32_t& i : value) {
-            i = ~i;
-        }
-        remove_zeroes(value);
-        return big_integer(-1, value) - 1;
+static void mul_balanced(word_t* res, word_t const* a, word_t const* b, size_t n, word_t* scratch);
+static void sqr_balanced(word_t* res, word_t const* a, size_t n, word_t* scratch);
+
+// x(1) and x(-1) for x = x0 + x1 t + x2 t^2 split into parts of k limbs, both k + 1 limbs wide
+static void toom3_evaluate(word_t* one, word_t* minus_one, word_t const* x, size_t k, size_t top) {
+    std::copy_n(x, k, one);
+    one[k] = 0;
+    add_span(one, k + 1, x + 2 * k, top);
+    std::copy(one, one + k + 1, minus_one);
+    sub_span(minus_one, k + 1, x + k, k);
+    add_span(one, k + 1, x + k, k);
+}
+
+// x(-2) = 2 (x(-1) + x2) - x0
+static void toom3_evaluate_minus_two(word_t* res, word_t const* minus_one, word_t const* x,
+                                     size_t k, size_t top) {
+    std::copy(minus_one, minus_one + k + 1, res);
+    add_span(res, k + 1, x + 2 * k, top);
+    add_span(res, k + 1, res, k + 1);
+    sub_span(res, k + 1, x, k);
+}
+
+// res[0, 2k) holds v(0) and res[4k, 2n) holds v(inf); v1, vm1 and vm2 are signed and 2k + 2 limbs wide
+static void toom3_interpolate(word_t* res, size_t n, size_t k, word_t* v1, word_t* vm1, word_t* vm2) {
+    size_t top = n - 2 * k;
+    size_t l2 = 2 * k + 2;
+    word_t const* r0 = res;
+    word_t const* r4 = res + 4 * k;
+    sub_span(vm2, l2, v1, l2);
+    divexact_by3(vm2, l2);
+    sub_span(v1, l2, vm1, l2);
+    shr1_signed(v1, l2);
+    sub_span(vm1, l2, r0, 2 * k);
+    negate_span(vm2, l2);
+    add_span(vm2, l2, vm1, l2);
+    shr1_signed(vm2, l2);
+    add_span(vm2, l2, r4, 2 * top);
+    add_span(vm2, l2, r4, 2 * top);
+    add_span(vm1, l2, v1, l2);
+    sub_span(vm1, l2, r4, 2 * top);
+    sub_span(v1, l2, vm2, l2);
+
+    add_span(res + k, 2 * n - k, v1, std::min(l2, 2 * n - k));
+    add_span(res + 2 * k, 2 * n - 2 * k, vm1, std::min(l2, 2 * n - 2 * k));
+    add_span(res + 3 * k, 2 * n - 3 * k, vm2, std::min(l2, 2 * n - 3 * k));
+}
+
+// Toom-3 over the points 0, 1, -1, -2, inf with Bodrato's interpolation sequence.
+// Intermediate values are kept as two's complement numbers of fixed width.
+static void mul_toom3(word_t* res, word_t const* a, word_t const* b, size_t n, word_t* scratch) {
+    size_t k = (n + 2) / 3;
+    size_t top = n - 2 * k;
+    size_t l1 = k + 1;
+    size_t l2 = 2 * l1;
+    word_t* a1 = scratch;
+    word_t* am1 = a1 + l1;
+    word_t* b1 = am1 + l1;
+    word_t* bm1 = b1 + l1;
+    word_t* v1 = bm1 + l1;
+    word_t* vm1 = v1 + l2;
+    word_t* vm2 = vm1 + l2;
+    word_t* next = vm2 + l2;
+
+    mul_balanced(res, a, b, k, scratch);
+    std::fill(res + 2 * k, res + 4 * k, 0U);
+    mul_balanced(res + 4 * k, a + 2 * k, b + 2 * k, top, scratch);
+
+    toom3_evaluate(a1, am1, a, k, top);
+    toom3_evaluate(b1, bm1, b, k, top);
+    mul_balanced(v1, a1, b1, l1, next);
+
+    toom3_evaluate_minus_two(a1, am1, a, k, top);
+    toom3_evaluate_minus_two(b1, bm1, b, k, top);
+    bool negative = abs_signed(a1, l1) != abs_signed(b1, l1);
+    mul_balanced(vm2, a1, b1, l1, next);
+    if (negative) {
+        negate_span(vm2, l2);
     }
-    remove_zeroes(value);
-    if (value.empty()) {
-        return 0;
+    negative = abs_signed(am1, l1) != abs_signed(bm1, l1);
+    mul_balanced(vm1, am1, bm1, l1, next);
+    if (negative) {
+        negate_span(vm1, l2);
     }
-    return big_integer(value);
+
+    toom3_interpolate(res, n, k, v1, vm1, vm2);
 }
 
+static void sqr_toom3(word_t* res, word_t const* a, size_t n, word_t* scratch) {
+    size_t k = (n + 2) / 3;
+    size_t top = n - 2 * k;
+    size_t l1 = k + 1;
+    size_t l2 = 2 * l1;
+    word_t* a1 = scratch;
+    word_t* am1 = a1 + l1;
+    word_t* v1 = am1 + l1;
+    word_t* vm1 = v1 + l2;
+    word_t* vm2 = vm1 + l2;
+    word_t* next = vm2 + l2;
+
+    sqr_balanced(res, a, k, scratch);
+    std::fill(res + 2 * k, res + 4 * k, 0U);
+    sqr_balanced(res + 4 * k, a + 2 * k, top, scratch);
+
+    toom3_evaluate(a1, am1, a, k, top);
+    sqr_balanced(v1, a1, l1, next);
+    toom3_evaluate_minus_two(a1, am1, a, k, top);
+    abs_signed(a1, l1);
+    sqr_balanced(vm2, a1, l1, next);
+    abs_signed(am1, l1);
+    sqr_balanced(vm1, am1, l1, next);
+
+    toom3_interpolate(res, n, k, v1, vm1, vm2);
+}
 
-big_integer& big_integer::bit_operation(big_integer const& rhs,
-                                        binary_operation<uint32_t> const& op) {
-    data_storage result(std::max(data.size(), rhs.data.size()) + 1);
-    size_t pos1 = not_zero_id(data);
-    size_t pos2 = not_zero_id(rhs.data);
-    for (size_t i = 0; i < result.size(); ++i) {
-        result[i] = op(get_signed(result.size() - i - 1, pos1),
-                       rhs.get_signed(result.size() - i - 1, pos2));
+// res[0, 2n) = a[0, n) * b[0, n), scratch holds mul_scratch(n) limbs
+static void mul_balanced(word_t* res, word_t const* a, word_t const* b, size_t n, word_t* scratch) {
+    if (n <= TOOM3_THRESHOLD) {
+        mul_karatsuba(res, a, b, n, scratch);
+    } else {
+        mul_toom3(res, a, b, n, scratch);
     }
-    *this = get_value(result);
-    return *this;
 }
 
-uint32_t bit_and(uint32_t a, uint32_t b) {
-    return a & b;
+static void sqr_balanced(word_t* res, word_t const* a, size_t n, word_t* scratch) {
+    if (n <= TOOM3_THRESHOLD) {
+        sqr_karatsuba(res, a, n, scratch);
+    } else {
+        sqr_toom3(res, a, n, scratch);
+    }
 }
 
-uint32_t bit_or(uint32_t a, uint32_t b) {
-    return a | b;
+namespace {
+struct ntt_prime {
+    uint64_t mod;
+    uint64_t root;
+};
+
+ntt_prime const NTT_PRIMES[3] = {
+        {0x7ffffe0000000001ULL, 7},
+        {0x7fffef0000000001ULL, 5},
+        {0x7fffe90000000001ULL, 7},
+};
 }
 
-uint32_t bit_xor(uint32_t a, uint32_t b) {
-    return a ^ b;
+static uint64_t mul_mod(uint64_t a, uint64_t b, uint64_t mod) {
+    return static_cast<uint64_t>(static_cast<__uint128_t>(a) * b % mod);
 }
 
-big_integer& big_integer::operator&=(big_integer const& rhs) {
-    return bit_operation(rhs, bit_and);
+static uint64_t pow_mod(uint64_t a, uint64_t e, uint64_t mod) {
+    uint64_t res = 1;
+    for (; e != 0; e >>= 1U) {
+        if (e & 1U) {
+            res = mul_mod(res, a, mod);
+        }
+        a = mul_mod(a, a, mod);
+    }
+    return res;
 }
 
-big_integer& big_integer::operator|=(big_integer const& rhs) {
-    return bit_operation(rhs, bit_or);
+// Montgomery form with R = 2^64; every prime is below 2^63, so sums of two residues never overflow
+static uint64_t to_mont(uint64_t a, uint64_t mod) {
+    return static_cast<uint64_t>((static_cast<__uint128_t>(a) << 64U) % mod);
 }
 
-big_integer& big_integer::operator^=(big_integer const& rhs) {
-    return bit_operation(rhs, bit_xor);
+static uint64_t mont_mul(uint64_t a, uint64_t b, uint64_t mod, uint64_t inv) {
+    __uint128_t t = static_cast<__uint128_t>(a) * b;
+    uint64_t m = static_cast<uint64_t>(t) * inv;
+    uint64_t u = static_cast<uint64_t>((t + static_cast<__uint128_t>(m) * mod) >> 64U);
+    return u >= mod ? u - mod : u;
 }
 
-big_integer& big_integer::operator<<=(int rhs) {
-    if (rhs < 0) {
-        return *this >>= (-rhs);
+static uint64_t mont_inv(uint64_t mod) {
+    uint64_t inv = mod;
+    for (size_t i = 0; i < 5; ++i) {
+        inv *= 2 - mod * inv;
     }
-    size_t big_shift = rhs / 32;
-    uint32_t small_shift = rhs % 32;
-    data.resize(big_shift + data.size(), 0U);
-    if (small_shift == 0) {
-        return *this;
+    return -inv;
+}
+
+// decimation in frequency without reordering: natural order in, bit-reversed order out
+static void ntt_forward(uint64_t* a, size_t len, uint64_t const* roots, uint64_t mod, uint64_t inv) {
+    for (size_t half = len / 2, stride = 1; half > 0; half /= 2, stride *= 2) {
+        for (size_t i = 0; i < len; i += 2 * half) {
+            for (size_t j = 0; j < half; ++j) {
+                uint64_t u = a[i + j];
+                uint64_t v = a[i + j + half];
+                uint64_t sum = u + v;
+                a[i + j] = sum >= mod ? sum - mod : sum;
+                a[i + j + half] = mont_mul(u + mod - v, roots[j * stride], mod, inv);
+            }
+        }
     }
-    return (*this *= static_cast<uint32_t>(1ULL << small_shift));
 }
 
-big_integer& big_integer::operator>>=(int rhs) {
-    if (rhs < 0) {
-        return *this <<= (-rhs);
+// decimation in time: bit-reversed order in, natural order out, not scaled by 1 / len
+static void ntt_inverse(uint64_t* a, size_t len, uint64_t const* roots, uint64_t mod, uint64_t inv) {
+    for (size_t half = 1, stride = len / 2; half < len; half *= 2, stride /= 2) {
+        for (size_t i = 0; i < len; i += 2 * half) {
+            for (size_t j = 0; j < half; ++j) {
+                uint64_t u = a[i + j];
+                uint64_t v = mont_mul(a[i + j + half], roots[j * stride], mod, inv);
+                uint64_t sum = u + v;
+                a[i + j] = sum >= mod ? sum - mod : sum;
+                a[i + j + half] = u >= v ? u - v : u + mod - v;
+            }
+        }
     }
-    size_t big_shift = rhs / 32;
-    uint32_t small_shift = rhs % 32;
-    if (big_shift >= data.size()) {
-        return (*this = 0);
+}
+
+static void ntt_roots(std::vector<uint64_t>& roots, uint64_t w, uint64_t mod, uint64_t inv) {
+    uint64_t w_mont = to_mont(w, mod);
+    roots[0] = to_mont(1, mod);
+    for (size_t i = 1; i < roots.size(); ++i) {
+        roots[i] = mont_mul(roots[i - 1], w_mont, mod, inv);
     }
-    size_t pos = not_zero_id(data);
-    data.resize(data.size() - big_shift);
-    data.insert(data.begin(), 0);
-    for (size_t i = 0; i < data.size(); ++i) {
-        data[i] = get_signed(data.size() - i - 1, pos);
+}
+
+// residues of the cyclic convolution of a and b modulo one prime, written to out[0, len);
+// squaring (a == b) needs a single forward transform
+static void ntt_convolution(uint64_t* out, word_t const* a, size_t n, word_t const* b, size_t m,
+                            size_t len, ntt_prime const& prime) {
+    uint64_t mod = prime.mod;
+    uint64_t inv = mont_inv(mod);
+    uint64_t w = pow_mod(prime.root, (mod - 1) / len, mod);
+    bool square = (a == b && n == m);
+    std::vector<uint64_t> roots(len / 2);
+    std::vector<uint64_t> other(square ? 0 : len, 0);
+
+    std::fill(out, out + len, 0);
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = a[i] % mod;
     }
-    uint64_t tmp = get_data64(data, 0);
-    uint64_t shifted = ((tmp << (32ULL - small_shift))
-                        | (tmp << 32U));
-    data[0] = shifted >> 32ULL;
-    shifted <<= 32ULL;
-    for (size_t i = 1; i < data.size(); ++i) {
-        shifted |= (get_data64(data, i) << (32ULL - small_shift));
-        data[i] = shifted >> 32ULL;
-        shifted <<= 32ULL;
+    ntt_roots(roots, w, mod, inv);
+    ntt_forward(out, len, roots.data(), mod, inv);
+    if (!square) {
+        for (size_t i = 0; i < m; ++i) {
+            other[i] = b[i] % mod;
+        }
+        ntt_forward(other.data(), len, roots.data(), mod, inv);
     }
-    return (*this = get_value(data));
-}
 
-big_integer big_integer::operator+() const {
-    return *this;
-}
+    uint64_t scale = mul_mod(to_mont(pow_mod(len, mod - 2, mod), mod), to_mont(1, mod), mod);
+    for (size_t i = 0; i < len; ++i) {
+        out[i] = mont_mul(mont_mul(out[i], square ? out[i] : other[i], mod, inv), scale, mod, inv);
+    }
 
-big_integer big_integer::operator-() const {
-    return big_integer(-this->sign, this->data);
+    ntt_roots(roots, pow_mod(w, mod - 2, mod), mod, inv);
+    ntt_inverse(out, len, roots.data(), mod, inv);
 }
 
-big_integer big_integer::operator~() const {
-    return -*this - 1;
-}
+// res[0, n + m) = a[0, n) * b[0, m), residues modulo three primes are joined with Garner's algorithm
+static void mul_ntt(word_t* res, word_t const* a, size_t n, word_t const* b, size_t m) {
+    size_t len = 1;
+    while (len < n + m) {
+        len *= 2;
+    }
+    std::vector<uint64_t> residues(3 * len);
+    for (size_t i = 0; i < 3; ++i) {
+        ntt_convolution(residues.data() + i * len, a, n, b, m, len, NTT_PRIMES[i]);
+    }
 
-big_integer& big_integer::operator++() {
-    return (*this += 1);
+    uint64_t p1 = NTT_PRIMES[0].mod;
+    uint64_t p2 = NTT_PRIMES[1].mod;
+    uint64_t p3 = NTT_PRIMES[2].mod;
+    uint64_t inv2 = mont_inv(p2);
+    uint64_t inv3 = mont_inv(p3);
+    uint64_t p1_inv_mod_p2 = to_mont(pow_mod(p1 % p2, p2 - 2, p2), p2);
+    uint64_t p1_inv_mod_p3 = to_mont(pow_mod(p1 % p3, p3 - 2, p3), p3);
+    uint64_t p2_inv_mod_p3 = to_mont(pow_mod(p2 % p3, p3 - 2, p3), p3);
+    __uint128_t p12 = static_cast<__uint128_t>(p1) * p2;
+    uint64_t p12_lo = static_cast<uint64_t>(p12);
+    uint64_t p12_hi = static_cast<uint64_t>(p12 >> 64U);
+
+    uint64_t acc[3] = {0, 0, 0};
+    for (size_t i = 0; i < n + m; ++i) {
+        uint64_t x1 = residues[i];
+        uint64_t r2 = residues[len + i];
+        uint64_t r3 = residues[2 * len + i];
+        uint64_t x1_2 = x1 >= p2 ? x1 - p2 : x1;
+        uint64_t x1_3 = x1 >= p3 ? x1 - p3 : x1;
+        uint64_t x2 = mont_mul(r2 >= x1_2 ? r2 - x1_2 : r2 + p2 - x1_2, p1_inv_mod_p2, p2, inv2);
+        uint64_t t = mont_mul(r3 >= x1_3 ? r3 - x1_3 : r3 + p3 - x1_3, p1_inv_mod_p3, p3, inv3);
+        uint64_t x2_3 = x2 >= p3 ? x2 - p3 : x2;
+        uint64_t x3 = mont_mul(t >= x2_3 ? t - x2_3 : t + p3 - x2_3, p2_inv_mod_p3, p3, inv3);
+
+        __uint128_t low = static_cast<__uint128_t>(p1) * x2 + x1;
+        __uint128_t mid = static_cast<__uint128_t>(p12_lo) * x3;
+        __uint128_t high = static_cast<__uint128_t>(p12_hi) * x3;
+        __uint128_t sum = static_cast<__uint128_t>(acc[0]) + static_cast<uint64_t>(low)
+                          + static_cast<uint64_t>(mid);
+        acc[0] = static_cast<uint64_t>(sum);
+        sum = (sum >> 64U) + acc[1] + static_cast<uint64_t>(low >> 64U) + static_cast<uint64_t>(mid >> 64U)
+              + static_cast<uint64_t>(high);
+        acc[1] = static_cast<uint64_t>(sum);
+        acc[2] += static_cast<uint64_t>(sum >> 64U) + static_cast<uint64_t>(high >> 64U);
+
+        res[i] = static_cast<word_t>(acc[0]);
+        if (WORD_BITS == 64) {
+            acc[0] = acc[1];
+            acc[1] = acc[2];
+            acc[2] = 0;
+        } else {
+            acc[0] = (acc[0] >> 32U) | (acc[1] << 32U);
+            acc[1] = (acc[1] >> 32U) | (acc[2] << 32U);
+            acc[2] >>= 32U;
+        }
+    }
 }
 
-big_integer big_integer::operator++(int) {
-    big_integer r(*this);
-    ++*this;
-    return r;
+// res[0, n + m) = a[0, n) * b[0, m)
+static void mul_long(word_t* res, word_t const* a, size_t n, word_t const* b, size_t m) {
+    if (n < m) {
+        std::swap(a, b);
+        std::swap(n, m);
+    }
+    if (m <= KARATSUBA_THRESHOLD) {
+        mul_basecase(res, a, n, b, m);
+        return;
+    }
+    if (m > NTT_THRESHOLD) {
+        mul_ntt(res, a, n, b, m);
+        return;
+    }
+    data_storage scratch(mul_scratch(m) + 2 * m);
+    word_t* part = scratch.data() + mul_scratch(m);
+    std::fill(res, res + n + m, 0U);
+    for (size_t i = 0; i < n; i += m) {
+        size_t len = std::min(m, n - i);
+        if (len == m) {
+            mul_balanced(part, a + i, b, m, scratch.data());
+        } else {
+            mul_long(part, b, m, a + i, len);
+        }
+        add_span(res + i, n + m - i, part, m + len);
+    }
 }
 
-big_integer& big_integer::operator--() {
-    return (*this -= 1);
+// res[0, 2n) = a[0, n) ^ 2
+static void sqr_long(word_t* res, word_t const* a, size_t n) {
+    if (n <= KARATSUBA_THRESHOLD) {
+        sqr_basecase(res, a, n);
+    } else if (n > NTT_THRESHOLD) {
+        mul_ntt(res, a, n, a, n);
+    } else {
+        data_storage scratch(mul_scratch(n));
+        sqr_balanced(res, a, n, scratch.data());
+    }
 }
 
-big_integer big_integer::operator--(int) {
-    big_integer r = *this;
-    --*this;
-    return r;
-}
+big_integer& big_integer::operator*=(big_integer const& rhs) {
+    if (sign == 0 || rhs.sign == 0) {
+        return (*this = 0);
+    }
 
-big_integer operator+(big_integer a, big_integer const& b) {
-    return a += b;
-}
+    data_storage res(size() + rhs.size());
+    if (this == &rhs || data == rhs.data) {
+        sqr_long(res.data(), data.data(), size());
+    } else {
+        mul_long(res.data(), data.data(), size(), rhs.data.data(), rhs.size());
+    }
 
-big_integer operator-(big_integer a, big_integer const& b) {
-    return a -= b;
+    data.swap(res);
+    remove_zeroes(data);
+    sign *= rhs.sign;
+    return *this;
 }
 
-big_integer operator*(big_integer a, big_integer const& b) {
-    return a *= b;
+// |*this| *= rhs, in place when rhs fits in a limb
+void big_integer::mul_word(uint64_t rhs) {
+    word_t words[64 / WORD_BITS];
+    size_t m = split_words(words, rhs);
+    if (m == 0 || sign == 0) {
+        data.clear();
+        sign = 0;
+    } else if (m == 1) {
+        word_t carry = mul_1(data.data(), data.data(), size(), words[0]);
+        if (carry != 0) {
+            data.push_back(carry);
+        }
+    } else {
+        data_storage res(size() + m);
+        mul_long(res.data(), data.data(), size(), words, m);
+        data.swap(res);
+        remove_zeroes(data);
+    }
 }
 
-big_integer operator/(big_integer a, big_integer const& b) {
-    return a /= b;
+big_integer& big_integer::operator*=(int64_t rhs) {
+    mul_word(magnitude_of(rhs));
+    sign *= sign_of(rhs);
+    return *this;
 }
 
-big_integer operator%(big_integer a, big_integer const& b) {
-    return a %= b;
+big_integer& big_integer::operator*=(uint64_t rhs) {
+    mul_word(rhs);
+    return *this;
 }
 
-big_integer operator&(big_integer a, big_integer const& b) {
-    return a &= b;
+big_integer& big_integer::operator*=(int rhs) {
+    return (*this *= static_cast<int64_t>(rhs));
 }
 
-big_integer operator|(big_integer a, big_integer const& b) {
-    return a |= b;
+big_integer& big_integer::operator*=(uint32_t rhs) {
+    return (*this *= static_cast<uint64_t>(rhs));
 }
 
-big_integer operator^(big_integer a, big_integer const& b) {
-    return a ^= b;
+static size_t leading_zeros(word_t x) {
+    size_t count = 0;
+    while (!(x >> (WORD_BITS - 1))) {
+        x <<= 1;
+        ++count;
+    }
+    return count;
 }
 
-big_integer operator<<(big_integer a, int b) {
-    return a <<= b;
+// res = a << shift for shift < WORD_BITS, returns the bits shifted out of the top limb
+static word_t shl_span(word_t* res, word_t const* a, size_t n, size_t shift) {
+    if (shift == 0) {
+        std::copy(a, a + n, res);
+        return 0;
+    }
+    word_t carry = 0;
+    for (size_t i = 0; i < n; ++i) {
+        word_t word = a[i];
+        res[i] = (word << shift) | carry;
+        carry = word >> (WORD_BITS - shift);
+    }
+    return carry;
 }
 
-big_integer operator>>(big_integer a, int b) {
-    return a >>= b;
+// floor((BASE^2 - 1) / d) - BASE for d with the top bit set, see Moller and Granlund,
+// "Improved division by invariant integers"
+static word_t reciprocal_word(word_t d) {
+    return low_word(((static_cast<dword_t>(~d) << WORD_BITS) | static_cast<word_t>(~static_cast<word_t>(0))) / d);
 }
 
-bool operator==(big_integer const& a, big_integer const& b) {
-    return !(a < b) && !(b < a);
+// divides u1 * BASE + u0 by the normalized d, u1 < d, with two multiplications by its reciprocal v
+static word_t div_preinv(word_t& rest, word_t u1, word_t u0, word_t d, word_t v) {
+    dword_t q = static_cast<dword_t>(v) * u1 + ((static_cast<dword_t>(u1 + 1) << WORD_BITS) | u0);
+    word_t q1 = static_cast<word_t>(q >> WORD_BITS);
+    word_t q0 = low_word(q);
+    word_t r = u0 - q1 * d;
+    if (r > q0) {
+        --q1;
+        r += d;
+    }
+    if (r >= d) {
+        ++q1;
+        r -= d;
+    }
+    rest = r;
+    return q1;
 }
 
-bool operator!=(big_integer const& a, big_integer const& b) {
-    return !(a == b);
+// q = a / (d >> shift) for the normalized d with reciprocal v, returns the remainder; q may alias a
+static word_t div_1_preinv(word_t* q, word_t const* a, size_t n, word_t d, word_t v, size_t shift) {
+    if (n == 0) {
+        return 0;
+    }
+    word_t rest = 0;
+    if (shift == 0) {
+        for (size_t i = n; i > 0; --i) {
+            q[i - 1] = div_preinv(rest, rest, a[i - 1], d, v);
+        }
+        return rest;
+    }
+    rest = a[n - 1] >> (WORD_BITS - shift);
+    for (size_t i = n; i > 0; --i) {
+        word_t low = (i > 1) ? a[i - 2] >> (WORD_BITS - shift) : 0;
+        q[i - 1] = div_preinv(rest, rest, (a[i - 1] << shift) | low, d, v);
+    }
+    return rest >> shift;
 }
 
-bool operator<(big_integer const& a, big_integer const& b) {
-    if (a.sign == b.sign) {
-        if (a.sign == 0) {
-            return false;
+static word_t short_div(data_storage& data, word_t rhs) {
+    size_t shift = leading_zeros(rhs);
+    word_t d = rhs << shift;
+    word_t rest = div_1_preinv(data.data(), data.data(), data.size(), d, reciprocal_word(d), shift);
+    remove_zeroes(data);
+    return rest;
+}
+
+// Knuth's Algorithm D. u has n + 1 limbs, v has m >= 2 limbs with the top bit set and u[n + 1 - m, n + 1) < v,
+// inv = reciprocal_word(v[m - 1]). Writes n + 1 - m quotient limbs into q and leaves the remainder in u[0, m).
+static void div_basecase(word_t* q, word_t* u, size_t n, word_t const* v, size_t m, word_t inv) {
+    word_t v1 = v[m - 1];
+    word_t v0 = v[m - 2];
+    for (size_t j = n + 1 - m; j > 0; --j) {
+        word_t* uj = u + j - 1;
+        dword_t qt = BASE - 1;
+        dword_t rest = static_cast<dword_t>(uj[m - 1]) + v1;
+        if (uj[m] < v1) {
+            word_t r;
+            qt = div_preinv(r, uj[m], uj[m - 1], v1, inv);
+            rest = r;
+        }
+        while (rest < BASE && qt * v0 > ((rest << WORD_BITS) | uj[m - 2])) {
+            qt--;
+            rest += v1;
+        }
+
+        word_t carry = 0;
+        word_t borrow = 0;
+        for (size_t i = 0; i < m; ++i) {
+            dword_t product = qt * v[i] + carry;
+            carry = static_cast<word_t>(product >> WORD_BITS);
+            word_t low = low_word(product);
+            word_t cur = uj[i] - low;
+            word_t next_borrow = (uj[i] < low) + (cur < borrow);
+            uj[i] = cur - borrow;
+            borrow = next_borrow;
+        }
+        carry += borrow;
+        bool negative = uj[m] < carry;
+        uj[m] -= carry;
+
+        if (negative) {
+            qt--;
+            add_span(uj, m + 1, v, m);
         }
-        return ((compare_abs(a.data, b.data) * a.sign) < 0);
+        q[j - 1] = low_word(qt);
     }
-    return a.sign < b.sign;
 }
 
-bool operator>(big_integer const& a, big_integer const& b) {
-    return !(a <= b);
+static int32_t compare_span(word_t const* a, word_t const* b, size_t n) {
+    while (n > 0 && a[n - 1] == b[n - 1]) {
+        --n;
+    }
+    if (n == 0) {
+        return 0;
+    }
+    return a[n - 1] < b[n - 1] ? -1 : 1;
 }
 
-bool operator<=(big_integer const& a, big_integer const& b) {
-    return a < b || a == b;
-}
+static word_t div_dc_n(word_t* q, word_t* u, word_t const* v, size_t n, word_t inv, word_t* scratch);
 
-bool operator>=(big_integer const& a, big_integer const& b) {
-    return !(a < b);
+// Divides u[0, k + m) by the normalized v[0, m), k <= m, estimating the quotient from the top k limbs of v
+// and correcting it by the rest. Returns the top quotient limb (0 or 1) and writes the others into q[0, k),
+// the remainder is left in u[0, m). Scratch must hold m limbs.
+static word_t div_dc_top(word_t* q, word_t* u, size_t k, word_t const* v, size_t m, word_t inv,
+                         word_t* scratch) {
+    word_t qh = div_dc_n(q, u + m - k, v + m - k, k, inv, scratch);
+    if (k == m) {
+        return qh;
+    }
+    word_t const one = 1;
+    mul_long(scratch, q, k, v, m - k);
+    word_t borrow = sub_span(u, m, scratch, m);
+    if (qh != 0) {
+        borrow += sub_span(u + k, m - k, v, m - k);
+    }
+    while (borrow != 0) {
+        qh -= sub_span(q, k, &one, 1);
+        borrow -= add_span(u, m, v, m);
+    }
+    return qh;
 }
 
-std::string to_string(big_integer const& a) {
-    std::string result;
-    if (a.sign == 0) {
-        return "0";
+// Burnikel-Ziegler division of u[0, 2n) by the normalized v[0, n), see div_dc_top for the result layout
+static word_t div_dc_n(word_t* q, word_t* u, word_t const* v, size_t n, word_t inv, word_t* scratch) {
+    if (n < DIV_DC_THRESHOLD) {
+        word_t qh = 0;
+        if (compare_span(u + n, v, n) >= 0) {
+            sub_span(u + n, n, v, n);
+            qh = 1;
+        }
+        div_basecase(q, u, 2 * n - 1, v, n, inv);
+        return qh;
     }
-    big_integer s(a);
-    s.sign = 1;
-    while (s > 0) {
-        big_integer temp(s % 10);
-        if (temp == 0) {
-            result.push_back('0');
+    size_t lo = n / 2;
+    size_t hi = n - lo;
+    word_t qh = div_dc_top(q + lo, u + lo, hi, v, n, inv, scratch);
+    div_dc_top(q, u, lo, v, n, inv, scratch);
+    return qh;
+}
+
+// same contract as div_basecase, splitting the quotient into blocks of m limbs from the top
+static void div_dc(word_t* q, word_t* u, size_t n, word_t const* v, size_t m, word_t inv) {
+    data_storage scratch(m);
+    size_t k = (n + 1 - m) % m;
+    if (k == 0) {
+        k = m;
+    }
+    for (size_t j = n + 1 - m - k; ; j -= m) {
+        if (k < DIV_DC_THRESHOLD) {
+            div_basecase(q + j, u + j, k + m - 1, v, m, inv);
         } else {
-            result.push_back(temp.data[0] + '0');
+            div_dc_top(q + j, u + j, k, v, m, inv, scratch.data());
         }
-        s /= 10;
-    }
-    if (a.sign == -1) {
-        result.push_back('-');
+        if (j == 0) {
+            break;
+        }
+        k = m;
     }
-    reverse(result.begin(), result.end());
-    return result;
 }
 
-big_integer &big_integer::operator=(big_integer const &other) {
-    big_integer tmp(other);
-    data.swap(tmp.data);
-    std::swap(sign, tmp.sign);
+// res = a >> shift for shift < WORD_BITS
+static void shr_span(word_t* res, word_t const* a, size_t n, size_t shift) {
+    if (shift == 0) {
+        std::copy(a, a + n, res);
+        return;
+    }
+    for (size_t i = 0; i < n; ++i) {
+        word_t high = (i + 1 < n) ? a[i + 1] << (WORD_BITS - shift) : 0;
+        res[i] = (a[i] >> shift) | high;
+    }
+}
+
+// replaces *this by the quotient truncated towards zero and stores the remainder, which takes
+// the sign of the dividend, into rest; rest may alias other but not *this
+void big_integer::div_mod(big_integer const& other, big_integer& rest) {
+    if (compare_abs(data, other.data) < 0) {
+        rest = std::move(*this);
+        *this = 0;
+        return;
+    }
+    if (other.size() >= NEWTON_DIV_THRESHOLD && size() >= 3 * other.size()) {
+        std::pair<big_integer, big_integer> result = big_integer_reciprocal(other).divmod(*this);
+        *this = std::move(result.first);
+        rest = std::move(result.second);
+        return;
+    }
+
+    big_integer_divisor(other).div_mod(*this, rest);
+}
+
+big_integer_divisor::big_integer_divisor(big_integer const& value)
+        : divisor(value.data), inverse(0), shift(0), sign(value.sign) {
+    if (sign == 0) {
+        throw std::runtime_error("Division by zero");
+    }
+    shift = leading_zeros(divisor.back());
+    shl_span(divisor.data(), divisor.data(), divisor.size(), shift);
+    inverse = reciprocal_word(divisor.back());
+}
+
+void big_integer_divisor::div_mod(big_integer& a, big_integer& rest) const {
+    size_t n = a.size();
+    size_t m = divisor.size();
+    if (n < m) {
+        rest = std::move(a);
+        a = 0;
+        return;
+    }
+    int32_t rest_sign = a.sign;
+    a.sign *= sign;
+
+    if (m == 1) {
+        rest = div_1_preinv(a.data.data(), a.data.data(), n, divisor[0], inverse, shift);
+        rest.sign *= rest_sign;
+    } else {
+        data_storage buffer(n + 1);
+        word_t* u = buffer.data();
+        u[n] = shl_span(u, a.data.data(), n, shift);
+        a.data.resize(n + 1 - m);
+        if (m < DIV_DC_THRESHOLD) {
+            div_basecase(a.data.data(), u, n, divisor.data(), m, inverse);
+        } else {
+            div_dc(a.data.data(), u, n, divisor.data(), m, inverse);
+        }
+        rest.data.resize(m);
+        shr_span(rest.data.data(), u, m, shift);
+        remove_zeroes(rest.data);
+        rest.sign = rest.data.empty() ? 0 : rest_sign;
+    }
+    remove_zeroes(a.data);
+    if (a.data.empty()) {
+        a.sign = 0;
+    }
+}
+
+big_integer big_integer_divisor::divide(big_integer const& a) const {
+    big_integer quotient = a;
+    big_integer rest;
+    div_mod(quotient, rest);
+    return quotient;
+}
+
+std::pair<big_integer, big_integer> big_integer_divisor::divmod(big_integer const& a) const {
+    std::pair<big_integer, big_integer> result(a, big_integer());
+    div_mod(result.first, result.second);
+    return result;
+}
+
+big_integer& big_integer::operator/=(big_integer const &other) {
+    big_integer rest;
+    div_mod(other, rest);
+    return *this;
+}
+
+big_integer& big_integer::operator%=(big_integer const& rhs) {
+    if (this == &rhs && sign != 0) {
+        return (*this = 0);
+    }
+    big_integer quotient(std::move(*this));
+    quotient.div_mod(rhs, *this);
+    return *this;
+}
+
+// |*this| /= rhs truncating, in place when rhs fits in a limb, returns the remainder of |*this|
+uint64_t big_integer::div_word(uint64_t rhs) {
+    word_t words[64 / WORD_BITS];
+    size_t m = split_words(words, rhs);
+    if (m == 0) {
+        throw std::runtime_error("Division by zero");
+    }
+    uint64_t rest = 0;
+    if (m == 1) {
+        rest = short_div(data, words[0]);
+    } else {
+        big_integer remainder;
+        div_mod(big_integer(1, data_storage(words, words + m)), remainder);
+        for (size_t i = remainder.size(); i > 0; --i) {
+            rest = static_cast<uint64_t>(static_cast<dword_t>(rest) << WORD_BITS) | remainder.data[i - 1];
+        }
+    }
+    if (data.empty()) {
+        sign = 0;
+    }
+    return rest;
+}
+
+big_integer& big_integer::operator/=(int64_t rhs) {
+    div_word(magnitude_of(rhs));
+    sign *= sign_of(rhs);
+    return *this;
+}
+
+big_integer& big_integer::operator/=(uint64_t rhs) {
+    div_word(rhs);
+    return *this;
+}
+
+big_integer& big_integer::operator/=(int rhs) {
+    return (*this /= static_cast<int64_t>(rhs));
+}
+
+big_integer& big_integer::operator/=(uint32_t rhs) {
+    return (*this /= static_cast<uint64_t>(rhs));
+}
+
+big_integer& big_integer::operator%=(int64_t rhs) {
+    return (*this %= magnitude_of(rhs));
+}
+
+// the remainder takes the sign of the dividend and reuses its words
+big_integer& big_integer::operator%=(uint64_t rhs) {
+    int32_t rest_sign = sign;
+    uint64_t rest = div_word(rhs);
+    word_t words[64 / WORD_BITS];
+    size_t n = split_words(words, rest);
+    data.assign(words, words + n);
+    sign = (n != 0)? rest_sign : 0;
+    return *this;
+}
+
+big_integer& big_integer::operator%=(int rhs) {
+    return (*this %= static_cast<int64_t>(rhs));
+}
+
+big_integer& big_integer::operator%=(uint32_t rhs) {
+    return (*this %= static_cast<uint64_t>(rhs));
+}
+
+std::pair<big_integer, big_integer> divmod(big_integer const& a, big_integer const& b) {
+    std::pair<big_integer, big_integer> result(a, big_integer());
+    result.first.div_mod(b, result.second);
+    return result;
+}
+
+// floor(a / BASE^k) for non-negative a
+big_integer big_integer::high_words(big_integer const& a, size_t k) {
+    if (k >= a.data.size()) {
+        return 0;
+    }
+    return big_integer(1, data_storage(a.data.begin() + k, a.data.end()));
+}
+
+// a mod BASE^k for non-negative a
+big_integer big_integer::low_words(big_integer const& a, size_t k) {
+    data_storage words(a.data.begin(), a.data.begin() + std::min(k, a.data.size()));
+    remove_zeroes(words);
+    if (words.empty()) {
+        return 0;
+    }
+    return big_integer(1, words);
+}
+
+big_integer_reciprocal::big_integer_reciprocal(big_integer const& value)
+        : divisor(value), shift(0), sign(value.sign) {
+    if (sign == 0) {
+        throw std::runtime_error("Division by zero");
+    }
+    divisor.sign = 1;
+    shift = leading_zeros(divisor.data.back());
+    divisor <<= static_cast<int>(shift);
+    inverse = reciprocal_of(divisor);
+}
+
+big_integer big_integer_reciprocal::power_of_base(size_t k) {
+    data_storage words(k + 1);
+    words[k] = 1;
+    return big_integer(1, words);
+}
+
+big_integer big_integer_reciprocal::shl_words(big_integer a, size_t k) {
+    if (a.sign != 0) {
+        a.data.insert(a.data.begin(), k, 0U);
+    }
+    return a;
+}
+
+// BASE^(2m) / v up to a few units for v of m limbs with the top bit set: the reciprocal of the top half
+// of v is lifted by one Newton step x += x * (BASE^(2m) - v * x) / BASE^(2m), doubling its precision
+big_integer big_integer_reciprocal::reciprocal_of(big_integer const& v) {
+    size_t m = v.data.size();
+    if (m < RECIPROCAL_THRESHOLD) {
+        return power_of_base(2 * m) / v;
+    }
+    size_t l = m / 2;
+    size_t h = m - l;
+    big_integer top = reciprocal_of(big_integer::high_words(v, l));
+    big_integer x = shl_words(top, l);
+    big_integer error = power_of_base(2 * m) - v * x;
+    if (error.sign >= 0) {
+        x += big_integer::high_words(top * error, m + h);
+    } else {
+        x -= big_integer::high_words(top * -error, m + h);
+    }
+    return x;
+}
+
+big_integer big_integer_reciprocal::divide(big_integer const& a) const {
+    return divmod(a).first;
+}
+
+// Barrett division by blocks of m limbs from the top: for cur < BASE^m * divisor the estimate
+// (cur / BASE^(m - 1)) * inverse / BASE^(m + 1) is within a few units of the quotient
+std::pair<big_integer, big_integer> big_integer_reciprocal::divmod(big_integer const& a) const {
+    if (a.sign == 0) {
+        return std::make_pair(big_integer(), big_integer());
+    }
+    big_integer value = a;
+    value.sign = 1;
+    value <<= static_cast<int>(shift);
+
+    size_t m = divisor.data.size();
+    size_t blocks = (value.data.size() + m - 1) / m;
+    data_storage quotient(blocks * m);
+    big_integer rest;
+    for (size_t j = blocks; j > 0; --j) {
+        size_t from = (j - 1) * m;
+        data_storage words(value.data.begin() + from, value.data.begin() + std::min(from + m, value.data.size()));
+        if (rest.sign != 0) {
+            words.resize(m + rest.data.size());
+            std::copy(rest.data.begin(), rest.data.end(), words.begin() + m);
+        }
+        remove_zeroes(words);
+        big_integer cur(words.empty() ? 0 : 1, words);
+        big_integer q = big_integer::high_words(big_integer::high_words(cur, m - 1) * inverse, m + 1);
+        rest = cur - q * divisor;
+        while (rest.sign < 0) {
+            rest += divisor;
+            --q;
+        }
+        while (rest >= divisor) {
+            rest -= divisor;
+            ++q;
+        }
+        std::copy(q.data.begin(), q.data.end(), quotient.begin() + (j - 1) * m);
+    }
+
+    rest >>= static_cast<int>(shift);
+    rest.sign *= a.sign;
+    remove_zeroes(quotient);
+    if (quotient.empty()) {
+        return std::make_pair(big_integer(), std::move(rest));
+    }
+    return std::make_pair(big_integer(a.sign * sign, quotient), std::move(rest));
+}
+
+// res = t * BASE^(-n) mod m for t < m * BASE^n of 2n limbs, destroys t; inv = -m^(-1) mod BASE
+static void redc(word_t* res, word_t* t, word_t const* m, size_t n, word_t inv) {
+    for (size_t i = 0; i < n; ++i) {
+        t[i] = addmul_1(t + i, m, n, t[i] * inv);
+    }
+    if (add_span(t + n, n, t, n) != 0 || compare_span(t + n, m, n) >= 0) {
+        sub_span(t + n, n, m, n);
+    }
+    std::copy(t + n, t + 2 * n, res);
+}
+
+// res = t mod m for t < m^2 of 2n limbs, where m and mu = floor(BASE^(2n) / m) are padded to n + 1 limbs;
+// work must hold 4n + 4 limbs and scratch mul_scratch(n + 1)
+static void barrett_reduce(word_t* res, word_t const* t, word_t const* m, word_t const* mu, size_t n,
+                           word_t* work, word_t* scratch) {
+    word_t* estimate = work;
+    word_t* product = work + 2 * n + 2;
+    mul_balanced(estimate, t + n - 1, mu, n + 1, scratch);
+    mul_balanced(product, estimate + n + 1, m, n + 1, scratch);
+    std::copy(t, t + n + 1, estimate);
+    sub_span(estimate, n + 1, product, n + 1);
+    while (compare_span(estimate, m, n + 1) >= 0) {
+        sub_span(estimate, n + 1, m, n + 1);
+    }
+    std::copy(estimate, estimate + n, res);
+}
+
+// a mod modulus as exactly modulus.size() limbs, dividing by the cached divisor of the positive modulus
+// only when a is negative or not already reduced
+data_storage big_integer::residue(big_integer const& a, big_integer const& modulus, big_integer_divisor const& divisor) {
+    size_t n = modulus.size();
+    data_storage res(n);
+    if (a.sign >= 0 && compare_abs(a.data, modulus.data) < 0) {
+        std::copy(a.data.begin(), a.data.end(), res.begin());
+        return res;
+    }
+    big_integer rest = divisor.divmod(a).second;
+    if (rest.sign < 0) {
+        rest += modulus;
+    }
+    std::copy(rest.data.begin(), rest.data.end(), res.begin());
+    return res;
+}
+
+static big_integer from_residue(data_storage& res) {
+    remove_zeroes(res);
+    if (res.empty()) {
+        return 0;
+    }
+    return big_integer(1, res);
+}
+
+static size_t window_size(size_t bits) {
+    size_t const limits[] = {8, 24, 80, 240, 672, 1792};
+    size_t window = 1;
+    while (window <= 6 && bits > limits[window - 1]) {
+        ++window;
+    }
+    return window;
+}
+
+// res = base^exponent by sliding-window exponentiation over the odd powers base, base^3, ... of n limbs,
+// with mul(res, a, b) and sqr(res, a) the context's products; res must hold the residue of 1
+template<typename Mul, typename Sqr>
+static void pow_residue(word_t* res, word_t const* base, size_t n, data_storage const& exponent, Mul mul, Sqr sqr) {
+    if (exponent.empty()) {
+        return;
+    }
+    size_t bits = exponent.size() * WORD_BITS - leading_zeros(exponent.back());
+    size_t window = window_size(bits);
+    data_storage table((static_cast<size_t>(1) << (window - 1)) * n);
+    std::copy(base, base + n, table.begin());
+    if (window > 1) {
+        data_storage square(n);
+        sqr(square.data(), base);
+        for (size_t i = n; i < table.size(); i += n) {
+            mul(table.data() + i, table.data() + i - n, square.data());
+        }
+    }
+
+    bool started = false;
+    for (size_t i = bits; i > 0; ) {
+        if (((exponent[(i - 1) / WORD_BITS] >> ((i - 1) % WORD_BITS)) & 1U) == 0) {
+            sqr(res, res);
+            --i;
+            continue;
+        }
+        size_t j = (i > window) ? i - window : 0;
+        while (((exponent[j / WORD_BITS] >> (j % WORD_BITS)) & 1U) == 0) {
+            ++j;
+        }
+        size_t value = 0;
+        for (size_t k = i; k > j; --k) {
+            value = (value << 1) | ((exponent[(k - 1) / WORD_BITS] >> ((k - 1) % WORD_BITS)) & 1U);
+            if (started) {
+                sqr(res, res);
+            }
+        }
+        word_t const* power = table.data() + (value >> 1) * n;
+        if (started) {
+            mul(res, res, power);
+        } else {
+            std::copy(power, power + n, res);
+            started = true;
+        }
+        i = j;
+    }
+}
+
+big_integer_montgomery::big_integer_montgomery(big_integer const& value)
+        : divisor(value), modulus(value), inverse(0) {
+    if (value.sign < 0 || (value.data[0] & 1U) == 0) {
+        throw std::runtime_error("Montgomery modulus must be odd and positive");
+    }
+    word_t m0 = value.data[0];
+    word_t x = m0;
+    for (size_t bits = 3; bits < WORD_BITS; bits *= 2) {
+        x *= 2 - m0 * x;
+    }
+    inverse = -x;
+    r2 = residue(big_integer(1) << static_cast<int>(2 * modulus.size() * WORD_BITS));
+}
+
+// a mod modulus as exactly n limbs
+data_storage big_integer_montgomery::residue(big_integer const& a) const {
+    return big_integer::residue(a, modulus, divisor);
+}
+
+// res = a * b * BASE^(-n) mod modulus, work must hold 2n + mul_scratch(n) limbs
+void big_integer_montgomery::mul(word_t* res, word_t const* a, word_t const* b, word_t* work) const {
+    size_t n = modulus.size();
+    mul_balanced(work, a, b, n, work + 2 * n);
+    redc(res, work, modulus.data.data(), n, inverse);
+}
+
+void big_integer_montgomery::sqr(word_t* res, word_t const* a, word_t* work) const {
+    size_t n = modulus.size();
+    sqr_balanced(work, a, n, work + 2 * n);
+    redc(res, work, modulus.data.data(), n, inverse);
+}
+
+big_integer big_integer_montgomery::mul_mod(big_integer const& a, big_integer const& b) const {
+    size_t n = modulus.size();
+    data_storage work(2 * n + mul_scratch(n));
+    data_storage res = residue(a);
+    data_storage other = residue(b);
+    mul(res.data(), res.data(), other.data(), work.data());
+    mul(res.data(), res.data(), r2.data(), work.data());
+    return from_residue(res);
+}
+
+big_integer big_integer_montgomery::sqr_mod(big_integer const& a) const {
+    size_t n = modulus.size();
+    data_storage work(2 * n + mul_scratch(n));
+    data_storage res = residue(a);
+    sqr(res.data(), res.data(), work.data());
+    mul(res.data(), res.data(), r2.data(), work.data());
+    return from_residue(res);
+}
+
+big_integer big_integer_montgomery::pow_mod(big_integer const& base, big_integer const& exponent) const {
+    if (exponent.sign < 0) {
+        throw std::runtime_error("Negative exponent");
+    }
+    size_t n = modulus.size();
+    data_storage work(2 * n + mul_scratch(n));
+    data_storage one(n);
+    one[0] = 1;
+    data_storage power = residue(base);
+    mul(power.data(), power.data(), r2.data(), work.data());
+    data_storage res(n);
+    mul(res.data(), one.data(), r2.data(), work.data());
+    pow_residue(res.data(), power.data(), n, exponent.data,
+                [&](word_t* r, word_t const* a, word_t const* b) { mul(r, a, b, work.data()); },
+                [&](word_t* r, word_t const* a) { sqr(r, a, work.data()); });
+    mul(res.data(), res.data(), one.data(), work.data());
+    return from_residue(res);
+}
+
+big_integer_barrett::big_integer_barrett(big_integer const& value)
+        : divisor(value), modulus(value) {
+    if (value.sign < 0) {
+        throw std::runtime_error("Barrett modulus must be positive");
+    }
+    size_t n = modulus.size();
+    padded = modulus.data;
+    padded.resize(n + 1);
+    mu = ((big_integer(1) << static_cast<int>(2 * n * WORD_BITS)) / modulus).data;
+    if (mu.size() > n + 1) {
+        // modulus is a power of BASE, one less keeps the estimate within the correction loop
+        mu.assign(n + 1, ~static_cast<word_t>(0));
+    }
+    mu.resize(n + 1);
+}
+
+data_storage big_integer_barrett::residue(big_integer const& a) const {
+    return big_integer::residue(a, modulus, divisor);
+}
+
+// res = a * b mod modulus, work must hold 6n + 4 + mul_scratch(n + 1) limbs
+void big_integer_barrett::mul(word_t* res, word_t const* a, word_t const* b, word_t* work) const {
+    size_t n = modulus.size();
+    mul_balanced(work, a, b, n, work + 6 * n + 4);
+    barrett_reduce(res, work, padded.data(), mu.data(), n, work + 2 * n, work + 6 * n + 4);
+}
+
+void big_integer_barrett::sqr(word_t* res, word_t const* a, word_t* work) const {
+    size_t n = modulus.size();
+    sqr_balanced(work, a, n, work + 6 * n + 4);
+    barrett_reduce(res, work, padded.data(), mu.data(), n, work + 2 * n, work + 6 * n + 4);
+}
+
+big_integer big_integer_barrett::mul_mod(big_integer const& a, big_integer const& b) const {
+    size_t n = modulus.size();
+    data_storage work(6 * n + 4 + mul_scratch(n + 1));
+    data_storage res = residue(a);
+    data_storage other = residue(b);
+    mul(res.data(), res.data(), other.data(), work.data());
+    return from_residue(res);
+}
+
+big_integer big_integer_barrett::sqr_mod(big_integer const& a) const {
+    size_t n = modulus.size();
+    data_storage work(6 * n + 4 + mul_scratch(n + 1));
+    data_storage res = residue(a);
+    sqr(res.data(), res.data(), work.data());
+    return from_residue(res);
+}
+
+big_integer big_integer_barrett::pow_mod(big_integer const& base, big_integer const& exponent) const {
+    if (exponent.sign < 0) {
+        throw std::runtime_error("Negative exponent");
+    }
+    size_t n = modulus.size();
+    data_storage work(6 * n + 4 + mul_scratch(n + 1));
+    data_storage power = residue(base);
+    data_storage res = residue(1);
+    pow_residue(res.data(), power.data(), n, exponent.data,
+                [&](word_t* r, word_t const* a, word_t const* b) { mul(r, a, b, work.data()); },
+                [&](word_t* r, word_t const* a) { sqr(r, a, work.data()); });
+    return from_residue(res);
+}
+
+big_integer pow(big_integer const& base, uint64_t exponent) {
+    if (exponent == 0) {
+        return 1;
+    }
+    if (base.sign == 0) {
+        return 0;
+    }
+    // base = odd * 2^shift, the power of two is applied by a single shift at the end
+    size_t shift = 0;
+    while (base.data[shift / WORD_BITS] >> (shift % WORD_BITS) == 0) {
+        shift += WORD_BITS;
+    }
+    while (((base.data[shift / WORD_BITS] >> (shift % WORD_BITS)) & 1U) == 0) {
+        ++shift;
+    }
+    // the final shift takes an int, checked by division so that shift * exponent cannot wrap either
+    if (shift != 0 && exponent > static_cast<uint64_t>(INT_MAX) / shift) {
+        throw std::runtime_error("Power is too large");
+    }
+    big_integer odd = base;
+    odd.sign = 1;
+    odd >>= static_cast<int>(shift);
+
+    size_t bits = 64;
+    while (((exponent >> (bits - 1)) & 1U) == 0) {
+        --bits;
+    }
+    size_t window = window_size(bits);
+    std::vector<big_integer> table(static_cast<size_t>(1) << (window - 1), odd);
+    if (window > 1) {
+        big_integer square = odd * odd;
+        for (size_t i = 1; i < table.size(); ++i) {
+            table[i] = table[i - 1] * square;
+        }
+    }
+
+    big_integer res;
+    for (size_t i = bits; i > 0; ) {
+        if (((exponent >> (i - 1)) & 1U) == 0) {
+            res *= res;
+            --i;
+            continue;
+        }
+        size_t j = (i > window) ? i - window : 0;
+        while (((exponent >> j) & 1U) == 0) {
+            ++j;
+        }
+        size_t value = static_cast<size_t>((exponent >> j) & ((static_cast<uint64_t>(1) << (i - j)) - 1));
+        if (res.sign == 0) {
+            res = table[value >> 1];
+        } else {
+            for (size_t k = j; k < i; ++k) {
+                res *= res;
+            }
+            res *= table[value >> 1];
+        }
+        i = j;
+    }
+    if (base.sign < 0 && (exponent & 1U) != 0) {
+        res = -res;
+    }
+    return res <<= static_cast<int>(shift * exponent);
+}
+
+big_integer pow_mod(big_integer const& base, big_integer const& exponent, big_integer const& modulus) {
+    big_integer m = modulus;
+    if (m.sign < 0) {
+        m.sign = 1;
+    }
+    if (m.sign != 0 && (m.data[0] & 1U) != 0) {
+        return big_integer_montgomery(m).pow_mod(base, exponent);
+    }
+    return big_integer_barrett(m).pow_mod(base, exponent);
+}
+
+// Cofactors of a Lehmer step: (a, b) becomes (u0 * a - v0 * b, v1 * b - u1 * a), with the signs reversed if odd
+struct lehmer_cofactors {
+    word_t u0, v0, u1, v1;
+    bool odd;
+};
+
+// floor(v / 2^shift) mod BASE^2
+static dword_t bits_at(data_storage const& v, size_t shift) {
+    size_t i = shift / WORD_BITS;
+    size_t r = shift % WORD_BITS;
+    word_t w[3];
+    for (size_t j = 0; j < 3; ++j) {
+        w[j] = (i + j < v.size()) ? v[i + j] : 0;
+    }
+    dword_t low = w[0] | (static_cast<dword_t>(w[1]) << WORD_BITS);
+    if (r == 0) {
+        return low;
+    }
+    return (low >> r) | (static_cast<dword_t>(w[2]) << (2 * WORD_BITS - r));
+}
+
+// Euclid's algorithm on the top 2 * WORD_BITS - 1 bits of a >= b > 0, taking a step only while it gives the
+// same quotient for both ends of the truncation interval and keeps the remainders at least BASE^keep
+static bool lehmer_step(data_storage const& a, data_storage const& b, size_t keep, lehmer_cofactors& m) {
+    size_t bits = a.size() * WORD_BITS - leading_zeros(a.back());
+    size_t shift = (bits > 2 * WORD_BITS - 1) ? bits - (2 * WORD_BITS - 1) : 0;
+    dword_t limit = 1;
+    if (keep * WORD_BITS > shift) {
+        if (keep * WORD_BITS - shift >= 2 * WORD_BITS - 1) {
+            return false;
+        }
+        limit = static_cast<dword_t>(1) << (keep * WORD_BITS - shift);
+    }
+    dword_t const cap = static_cast<dword_t>(1) << (WORD_BITS - 1);
+    dword_t x = bits_at(a, shift);
+    dword_t y = bits_at(b, shift);
+    dword_t u0 = 1, v0 = 0, u1 = 0, v1 = 1;
+    bool odd = false;
+    bool moved = false;
+    while (true) {
+        dword_t x1 = odd ? x - u0 : x + u0;
+        dword_t y1 = odd ? y + u1 : y - u1;
+        dword_t x2 = odd ? x + v0 : x - v0;
+        dword_t y2 = odd ? y - v1 : y + v1;
+        if (y1 == 0 || y2 == 0) {
+            break;
+        }
+        dword_t q = x1 / y1;
+        if (q >= cap || q != x2 / y2) {
+            break;
+        }
+        dword_t next_u = u0 + q * u1;
+        dword_t next_v = v0 + q * v1;
+        dword_t next_y = x - q * y;
+        if (next_u >= cap || next_v >= cap || next_y < limit + (odd ? next_u : next_v)) {
+            break;
+        }
+        x = y;
+        y = next_y;
+        u0 = u1;
+        v0 = v1;
+        u1 = next_u;
+        v1 = next_v;
+        odd = !odd;
+        moved = true;
+    }
+    m = {low_word(u0), low_word(v0), low_word(u1), low_word(v1), odd};
+    return moved;
+}
+
+// res = p * x - q * y, which must be non-negative
+static void submul_pair(word_t* res, word_t const* x, word_t p, word_t const* y, word_t q, size_t n) {
+    word_t carry_x = 0;
+    word_t carry_y = 0;
+    word_t borrow = 0;
+    for (size_t i = 0; i < n; ++i) {
+        dword_t px = static_cast<dword_t>(p) * x[i] + carry_x;
+        dword_t qy = static_cast<dword_t>(q) * y[i] + carry_y;
+        carry_x = low_word(px >> WORD_BITS);
+        carry_y = low_word(qy >> WORD_BITS);
+        word_t lx = low_word(px);
+        word_t ly = low_word(qy);
+        res[i] = lx - ly - borrow;
+        borrow = (lx < ly || lx - ly < borrow) ? 1 : 0;
+    }
+}
+
+static void lehmer_apply(data_storage& a, data_storage& b, lehmer_cofactors const& m,
+                         data_storage& next_a, data_storage& next_b) {
+    size_t n = a.size();
+    b.resize(n);
+    next_a.resize(n);
+    next_b.resize(n);
+    if (m.odd) {
+        submul_pair(next_a.data(), b.data(), m.v0, a.data(), m.u0, n);
+        submul_pair(next_b.data(), a.data(), m.u1, b.data(), m.v1, n);
+    } else {
+        submul_pair(next_a.data(), a.data(), m.u0, b.data(), m.v0, n);
+        submul_pair(next_b.data(), b.data(), m.v1, a.data(), m.u1, n);
+    }
+    a.swap(next_a);
+    b.swap(next_b);
+    remove_zeroes(a);
+    remove_zeroes(b);
+}
+
+// Rows of cofactors are combined the same way as a and b
+static void lehmer_apply(big_integer* cofactors, lehmer_cofactors const& m) {
+    big_integer u0(m.u0), v0(m.v0), u1(m.u1), v1(m.v1);
+    for (size_t j = 0; j < 2; ++j) {
+        big_integer a = cofactors[j];
+        big_integer& b = cofactors[2 + j];
+        if (m.odd) {
+            cofactors[j] = v0 * b - u0 * a;
+            b = u1 * a - v1 * b;
+        } else {
+            cofactors[j] = u0 * a - v0 * b;
+            b = v1 * b - u1 * a;
+        }
+    }
+}
+
+// cofactors = m * cofactors
+static void multiply_cofactors(big_integer* cofactors, big_integer const* m) {
+    for (size_t j = 0; j < 2; ++j) {
+        big_integer a = cofactors[j];
+        big_integer b = cofactors[2 + j];
+        cofactors[j] = m[0] * a + m[1] * b;
+        cofactors[2 + j] = m[2] * a + m[3] * b;
+    }
+}
+
+// Reduces a >= b >= 0 by Euclid's algorithm while the next remainder keeps more than keep limbs, down to b = 0
+// for keep = 0; cofactors, if given, are updated so that (a, b) = cofactors * (a0, b0) holds throughout
+bool big_integer::gcd_reduce(big_integer& a, big_integer& b, size_t keep, big_integer* cofactors) {
+    bool moved = false;
+    data_storage next_a;
+    data_storage next_b;
+    while (b.size() > keep) {
+        if (keep == 0 && b.size() >= HGCD_THRESHOLD && 2 * b.size() > a.size() + 2) {
+            big_integer m[4] = {1, 0, 0, 1};
+            if (half_gcd(a, b, m)) {
+                if (cofactors != nullptr) {
+                    multiply_cofactors(cofactors, m);
+                }
+                moved = true;
+                continue;
+            }
+        }
+        if (keep == 0 && cofactors == nullptr && b.size() == 1) {
+            word_t x = short_div(a.data, b.data[0]);
+            word_t y = b.data[0];
+            while (x != 0) {
+                word_t t = y % x;
+                y = x;
+                x = t;
+            }
+            a = big_integer(y);
+            b = 0;
+            return true;
+        }
+        lehmer_cofactors m;
+        if (lehmer_step(a.data, b.data, keep, m)) {
+            lehmer_apply(a.data, b.data, m, next_a, next_b);
+            if (cofactors != nullptr) {
+                lehmer_apply(cofactors, m);
+            }
+        } else {
+            std::pair<big_integer, big_integer> qr = divmod(a, b);
+            if (keep != 0 && qr.second.size() <= keep) {
+                break;
+            }
+            a = std::move(b);
+            b = std::move(qr.second);
+            if (cofactors != nullptr) {
+                for (size_t j = 0; j < 2; ++j) {
+                    big_integer next = cofactors[j] - qr.first * cofactors[2 + j];
+                    cofactors[j] = std::move(cofactors[2 + j]);
+                    cofactors[2 + j] = std::move(next);
+                }
+            }
+        }
+        moved = true;
+    }
+    return moved;
+}
+
+// Reduces a >= b >= 0 of n limbs like gcd_reduce with keep = n / 2 + 1, recursing on the top limbs first: their
+// cofactors are those of the whole numbers as long as the remainders stay longer than the cofactors
+bool big_integer::half_gcd(big_integer& a, big_integer& b, big_integer* cofactors) {
+    size_t n = a.size();
+    size_t keep = n / 2 + 1;
+    if (b.size() <= keep) {
+        return false;
+    }
+    bool moved = false;
+    if (n >= HGCD_THRESHOLD) {
+        moved = half_gcd_top(a, b, n / 2, cofactors);
+        size_t m = a.size();
+        if (b.size() > keep && 2 * keep > m) {
+            moved = half_gcd_top(a, b, 2 * keep - m, cofactors) || moved;
+        }
+    }
+    return gcd_reduce(a, b, keep, cofactors) || moved;
+}
+
+// Runs half_gcd on a / BASE^k and b / BASE^k and applies the cofactors found to the whole of a and b
+bool big_integer::half_gcd_top(big_integer& a, big_integer& b, size_t k, big_integer* cofactors) {
+    big_integer high_a = high_words(a, k);
+    big_integer high_b = high_words(b, k);
+    big_integer m[4] = {1, 0, 0, 1};
+    if (!half_gcd(high_a, high_b, m)) {
+        return false;
+    }
+    big_integer low_a = low_words(a, k);
+    big_integer low_b = low_words(b, k);
+    high_a.data.insert(high_a.data.begin(), high_a.sign != 0 ? k : 0, 0U);
+    high_b.data.insert(high_b.data.begin(), high_b.sign != 0 ? k : 0, 0U);
+    a = high_a + m[0] * low_a + m[1] * low_b;
+    b = high_b + m[2] * low_a + m[3] * low_b;
+    // the last quotient may be off by the truncation, which only costs a few more steps
+    if (a.sign < 0) {
+        a.sign = 1;
+        m[0] = -m[0];
+        m[1] = -m[1];
+    }
+    if (b.sign < 0) {
+        b.sign = 1;
+        m[2] = -m[2];
+        m[3] = -m[3];
+    }
+    if (compare_abs(a.data, b.data) < 0) {
+        std::swap(a, b);
+        std::swap(m[0], m[2]);
+        std::swap(m[1], m[3]);
+    }
+    multiply_cofactors(cofactors, m);
+    return true;
+}
+
+big_integer gcd(big_integer const& a, big_integer const& b) {
+    big_integer x = a;
+    big_integer y = b;
+    x.sign = (x.sign != 0) ? 1 : 0;
+    y.sign = (y.sign != 0) ? 1 : 0;
+    if (compare_abs(x.data, y.data) < 0) {
+        std::swap(x, y);
+    }
+    big_integer::gcd_reduce(x, y, 0, nullptr);
+    return x;
+}
+
+big_integer lcm(big_integer const& a, big_integer const& b) {
+    if (a == 0 || b == 0) {
+        return 0;
+    }
+    big_integer res = a / gcd(a, b) * b;
+    return (res < 0) ? -res : res;
+}
+
+// Returns g = gcd(a, b) >= 0 with a * x + b * y = g, choosing |x| <= |b| / (2g)
+big_integer extended_gcd(big_integer const& a, big_integer const& b, big_integer& x, big_integer& y) {
+    big_integer u = a;
+    big_integer v = b;
+    u.sign = (u.sign != 0) ? 1 : 0;
+    v.sign = (v.sign != 0) ? 1 : 0;
+    bool swapped = compare_abs(u.data, v.data) < 0;
+    if (swapped) {
+        std::swap(u, v);
+    }
+    big_integer cofactors[4] = {1, 0, 0, 1};
+    big_integer::gcd_reduce(u, v, 0, cofactors);
+    if (u.sign == 0) {
+        x = 0;
+        y = 0;
+        return u;
+    }
+    // x and y may alias a and b, so both are found before either is written
+    big_integer res_x = cofactors[swapped ? 1 : 0];
+    if (a.sign < 0) {
+        res_x.sign = -res_x.sign;
+    }
+    if (b.sign != 0) {
+        big_integer period = b / u;
+        period.sign = 1;
+        res_x %= period;
+        big_integer twice = res_x + res_x;
+        if (compare_abs(twice.data, period.data) > 0) {
+            res_x -= (res_x.sign < 0) ? -period : period;
+        }
+    }
+    big_integer res_y = (b.sign != 0) ? (u - a * res_x) / b : big_integer(0);
+    x = std::move(res_x);
+    y = std::move(res_y);
+    return u;
+}
+
+static size_t bit_length(data_storage const& a) {
+    return a.empty() ? 0 : a.size() * WORD_BITS - leading_zeros(a.back());
+}
+
+// floor(a^(1/k)) for a root of at most 31 bits, from a floating-point estimate on the top bits of a
+static big_integer iroot_estimate(data_storage const& a, size_t bits, uint64_t k) {
+    size_t shift = (bits > 64) ? bits - 64 : 0;
+    double top = static_cast<double>(bits_at(a, shift));
+    double estimate = std::exp2((std::log2(top) + static_cast<double>(shift)) / static_cast<double>(k));
+    big_integer res(static_cast<word_t>(estimate));
+    big_integer value(1, a);
+    while (res > 0 && pow(res, k) > value) {
+        --res;
+    }
+    while (pow(res + 1, k) <= value) {
+        ++res;
+    }
+    return res;
+}
+
+// One step of Newton's iteration x -> x - ceil((x^k - a) / (k x^(k - 1))), which moves any x above the root
+// closer to it without passing floor(a^(1/k)); returns false, leaving x as is, once x^k <= a
+static bool iroot_step(big_integer& x, big_integer const& a, uint64_t k) {
+    big_integer power = pow(x, k - 1);
+    big_integer excess = power * x - a;
+    if (excess <= 0) {
+        return false;
+    }
+    power *= big_integer(static_cast<word_t>(k));
+    excess += power - 1;
+    x -= excess / power;
+    return true;
+}
+
+// floor(a^(1/k)) for a > 0 and k < bit_length(a), or with exact = false some value a few units above it. The
+// root of the top bits of a, lifted back, starts a single Newton step that doubles its precision; only the
+// last level iterates to the exact root, where the excess is small and each step divides by a short quotient
+static big_integer iroot_newton(data_storage const& a, uint64_t k, bool exact) {
+    size_t bits = bit_length(a);
+    size_t root_bits = (bits + k - 1) / k;
+    if (root_bits <= 31) {
+        return iroot_estimate(a, bits, k);
+    }
+    size_t half = root_bits / 2;
+    size_t drop = k * half;
+    data_storage high(a.size() - drop / WORD_BITS);
+    shr_span(high.data(), a.data() + drop / WORD_BITS, high.size(), drop % WORD_BITS);
+    remove_zeroes(high);
+
+    big_integer value(1, a);
+    big_integer x = (iroot_newton(high, k, false) + 1) << static_cast<int>(half);
+    if (iroot_step(x, value, k) && exact) {
+        while (iroot_step(x, value, k)) {}
+    }
+    return x;
+}
+
+big_integer isqrt(big_integer const& a) {
+    if (a < 0) {
+        throw std::runtime_error("Square root of negative number");
+    }
+    return iroot(a, 2);
+}
+
+// Truncates towards zero for negative a and odd k
+big_integer iroot(big_integer const& a, uint64_t k) {
+    if (k == 0) {
+        throw std::runtime_error("Zero root degree");
+    }
+    if (a.sign < 0 && k % 2 == 0) {
+        throw std::runtime_error("Even root of negative number");
+    }
+    if (a.sign == 0 || k == 1) {
+        return a;
+    }
+    big_integer res = (k >= bit_length(a.data)) ? big_integer(1) : iroot_newton(a.data, k, true);
+    res.sign = a.sign;
+    return res;
+}
+
+// Word of the two's complement form of a sign-magnitude value, mask is all ones for a negative value and carry
+// starts as its lowest bit, so that ~x + 1 is formed one word at a time
+static word_t twos_complement_word(word_t x, word_t mask, word_t& carry) {
+    word_t res = (x ^ mask) + carry;
+    carry = (res < carry) ? 1 : 0;
+    return res;
+}
+
+struct twos_complement_pass {
+    word_t mask_a, mask_b, mask_res;
+    word_t carry_a, carry_b, carry_res;
+};
+
+// res[i] = op(a[i], b[i]) on [from, to) through two's complement, with a null a or b read as zero words. The
+// carries die out at the lowest non-zero word of each value, after which the conversions are plain xors
+template<typename Op>
+static void bit_operation_span(word_t* res, word_t const* a, word_t const* b, size_t from, size_t to,
+                               twos_complement_pass& pass, Op op) {
+    size_t i = from;
+    for (; i < to && (pass.carry_a | pass.carry_b | pass.carry_res) != 0; ++i) {
+        word_t x = twos_complement_word(a != nullptr ? a[i] : 0, pass.mask_a, pass.carry_a);
+        word_t y = twos_complement_word(b != nullptr ? b[i] : 0, pass.mask_b, pass.carry_b);
+        res[i] = twos_complement_word(op(x, y), pass.mask_res, pass.carry_res);
+    }
+    word_t mask_a = pass.mask_a;
+    word_t mask_b = pass.mask_b;
+    word_t mask_res = pass.mask_res;
+    if (a != nullptr && b != nullptr) {
+        for (; i < to; ++i) {
+            res[i] = op(a[i] ^ mask_a, b[i] ^ mask_b) ^ mask_res;
+        }
+    } else if (a != nullptr) {
+        for (; i < to; ++i) {
+            res[i] = op(a[i] ^ mask_a, mask_b) ^ mask_res;
+        }
+    } else {
+        for (; i < to; ++i) {
+            res[i] = op(mask_a, b[i] ^ mask_b) ^ mask_res;
+        }
+    }
+}
+
+// The operands are converted to two's complement, combined and converted back within one pass over the words
+template<typename Op>
+big_integer& big_integer::bit_operation(big_integer const& rhs, Op op) {
+    size_t n = data.size();
+    size_t m = rhs.data.size();
+    twos_complement_pass pass;
+    pass.mask_a = (sign < 0) ? ~static_cast<word_t>(0) : 0;
+    pass.mask_b = (rhs.sign < 0) ? ~static_cast<word_t>(0) : 0;
+    pass.mask_res = op(pass.mask_a, pass.mask_b);
+    pass.carry_a = pass.mask_a & 1U;
+    pass.carry_b = pass.mask_b & 1U;
+    pass.carry_res = pass.mask_res & 1U;
+    data.resize(std::max(n, m));
+    word_t* words = data.data();
+    word_t const* other = rhs.data.data();
+    size_t common = std::min(n, m);
+    bit_operation_span(words, words, other, 0, common, pass, op);
+    if (n > m) {
+        bit_operation_span(words, words, nullptr, common, n, pass, op);
+    } else {
+        bit_operation_span(words, nullptr, other, common, m, pass, op);
+    }
+    if (pass.carry_res != 0) {
+        data.push_back(1);
+    }
+    remove_zeroes(data);
+    sign = data.empty() ? 0 : (pass.mask_res != 0 ? -1 : 1);
+    return *this;
+}
+
+big_integer& big_integer::operator&=(big_integer const& rhs) {
+    return bit_operation(rhs, std::bit_and<word_t>());
+}
+
+big_integer& big_integer::operator|=(big_integer const& rhs) {
+    return bit_operation(rhs, std::bit_or<word_t>());
+}
+
+big_integer& big_integer::operator^=(big_integer const& rhs) {
+    return bit_operation(rhs, std::bit_xor<word_t>());
+}
+
+big_integer& big_integer::operator<<=(int rhs) {
+    if (rhs < 0) {
+        return *this >>= (-rhs);
+    }
+    if (sign == 0) {
+        return *this;
+    }
+    size_t big_shift = rhs / WORD_BITS;
+    size_t small_shift = rhs % WORD_BITS;
+    size_t n = data.size();
+    if (data.capacity() < n + big_shift + 1) {
+        data_storage shifted(n + big_shift + 1);
+        shifted[n + big_shift] = shl_span(shifted.data() + big_shift, data.data(), n, small_shift);
+        data.swap(shifted);
+        if (data.back() == 0) {
+            data.pop_back();
+        }
+        return *this;
+    }
+    data.resize(n + big_shift + 1);
+    word_t* words = data.data();
+    if (small_shift == 0) {
+        std::copy_backward(words, words + n, words + n + big_shift);
+        words[n + big_shift] = 0;
+    } else {
+        // funnel shifts from the top down, so the words can move up in place
+        words[n + big_shift] = words[n - 1] >> (WORD_BITS - small_shift);
+        for (size_t i = n - 1; i > 0; --i) {
+            words[i + big_shift] = (words[i] << small_shift) | (words[i - 1] >> (WORD_BITS - small_shift));
+        }
+        words[big_shift] = words[0] << small_shift;
+    }
+    std::fill(words, words + big_shift, 0U);
+    if (data.back() == 0) {
+        data.pop_back();
+    }
+    return *this;
+}
+
+// floor division by 2^rhs: a negative value whose shifted out bits are not all zero moves one further down
+big_integer& big_integer::operator>>=(int rhs) {
+    if (rhs < 0) {
+        return *this <<= (-rhs);
+    }
+    if (sign == 0) {
+        return *this;
+    }
+    size_t big_shift = rhs / WORD_BITS;
+    size_t small_shift = rhs % WORD_BITS;
+    size_t n = data.size();
+    bool lost = big_shift >= n;
+    for (size_t i = 0; i < std::min(big_shift, n) && !lost; ++i) {
+        lost = data[i] != 0;
+    }
+    if (big_shift >= n) {
+        data.clear();
+    } else {
+        lost = lost || (small_shift != 0 && (data[big_shift] << (WORD_BITS - small_shift)) != 0);
+        shr_span(data.data(), data.data() + big_shift, n - big_shift, small_shift);
+        data.resize(n - big_shift);
+        remove_zeroes(data);
+    }
+    if (sign < 0 && lost) {
+        increment_abs(data);
+    }
+    if (data.empty()) {
+        sign = 0;
+    }
+    return *this;
+}
+
+big_integer big_integer::operator+() const {
+    return *this;
+}
+
+big_integer big_integer::operator-() const {
+    return big_integer(-this->sign, this->data);
+}
+
+// ~x = -x - 1 moves the magnitude one away from zero for x >= 0 and one towards it otherwise
+big_integer big_integer::operator~() const {
+    big_integer res(*this);
+    if (sign >= 0) {
+        increment_abs(res.data);
+        res.sign = -1;
+    } else {
+        decrement_abs(res.data);
+        res.sign = res.data.empty() ? 0 : 1;
+    }
+    return res;
+}
+
+big_integer& big_integer::operator++() {
+    if (sign >= 0) {
+        increment_abs(data);
+        sign = 1;
+    } else {
+        decrement_abs(data);
+        sign = data.empty() ? 0 : -1;
+    }
+    return *this;
+}
+
+big_integer big_integer::operator++(int) {
+    big_integer r(*this);
+    ++*this;
+    return r;
+}
+
+big_integer& big_integer::operator--() {
+    if (sign <= 0) {
+        increment_abs(data);
+        sign = -1;
+    } else {
+        decrement_abs(data);
+        sign = data.empty() ? 0 : 1;
+    }
+    return *this;
+}
+
+big_integer big_integer::operator--(int) {
+    big_integer r = *this;
+    --*this;
+    return r;
+}
+
+big_integer operator+(big_integer a, big_integer const& b) {
+    a += b;
+    return a;
+}
+
+big_integer operator+(big_integer const& a, big_integer&& b) {
+    return std::move(b += a);
+}
+
+big_integer operator+(big_integer&& a, big_integer&& b) {
+    if (b.data.capacity() > a.data.capacity()) {
+        return std::move(b += a);
+    }
+    return std::move(a += b);
+}
+
+big_integer operator-(big_integer a, big_integer const& b) {
+    a -= b;
+    return a;
+}
+
+big_integer operator-(big_integer const& a, big_integer&& b) {
+    b -= a;
+    b.sign = -b.sign;
+    return std::move(b);
+}
+
+big_integer operator-(big_integer&& a, big_integer&& b) {
+    if (b.data.capacity() > a.data.capacity()) {
+        b -= a;
+        b.sign = -b.sign;
+        return std::move(b);
+    }
+    return std::move(a -= b);
+}
+
+big_integer operator*(big_integer a, big_integer const& b) {
+    a *= b;
+    return a;
+}
+
+big_integer operator*(big_integer const& a, big_integer&& b) {
+    return std::move(b *= a);
+}
+
+big_integer operator*(big_integer&& a, big_integer&& b) {
+    if (b.data.capacity() > a.data.capacity()) {
+        return std::move(b *= a);
+    }
+    return std::move(a *= b);
+}
+
+big_integer operator/(big_integer a, big_integer const& b) {
+    a /= b;
+    return a;
+}
+
+big_integer operator%(big_integer a, big_integer const& b) {
+    a %= b;
+    return a;
+}
+
+big_integer operator+(big_integer a, int b) {
+    a += b;
+    return a;
+}
+
+big_integer operator+(big_integer a, int64_t b) {
+    a += b;
+    return a;
+}
+
+big_integer operator+(big_integer a, uint64_t b) {
+    a += b;
+    return a;
+}
+
+big_integer operator+(big_integer a, uint32_t b) {
+    a += b;
+    return a;
+}
+
+big_integer operator-(big_integer a, int b) {
+    a -= b;
+    return a;
+}
+
+big_integer operator-(big_integer a, int64_t b) {
+    a -= b;
+    return a;
+}
+
+big_integer operator-(big_integer a, uint64_t b) {
+    a -= b;
+    return a;
+}
+
+big_integer operator-(big_integer a, uint32_t b) {
+    a -= b;
+    return a;
+}
+
+big_integer operator*(big_integer a, int b) {
+    a *= b;
+    return a;
+}
+
+big_integer operator*(big_integer a, int64_t b) {
+    a *= b;
+    return a;
+}
+
+big_integer operator*(big_integer a, uint64_t b) {
+    a *= b;
+    return a;
+}
+
+big_integer operator*(big_integer a, uint32_t b) {
+    a *= b;
+    return a;
+}
+
+big_integer operator/(big_integer a, int b) {
+    a /= b;
+    return a;
+}
+
+big_integer operator/(big_integer a, int64_t b) {
+    a /= b;
+    return a;
+}
+
+big_integer operator/(big_integer a, uint64_t b) {
+    a /= b;
+    return a;
+}
+
+big_integer operator/(big_integer a, uint32_t b) {
+    a /= b;
+    return a;
+}
+
+big_integer operator%(big_integer a, int b) {
+    a %= b;
+    return a;
+}
+
+big_integer operator%(big_integer a, int64_t b) {
+    a %= b;
+    return a;
+}
+
+big_integer operator%(big_integer a, uint64_t b) {
+    a %= b;
+    return a;
+}
+
+big_integer operator%(big_integer a, uint32_t b) {
+    a %= b;
+    return a;
+}
+
+big_integer operator+(int a, big_integer b) {
+    b += a;
+    return b;
+}
+
+big_integer operator+(int64_t a, big_integer b) {
+    b += a;
+    return b;
+}
+
+big_integer operator+(uint64_t a, big_integer b) {
+    b += a;
+    return b;
+}
+
+big_integer operator+(uint32_t a, big_integer b) {
+    b += a;
+    return b;
+}
+
+big_integer operator*(int a, big_integer b) {
+    b *= a;
+    return b;
+}
+
+big_integer operator*(int64_t a, big_integer b) {
+    b *= a;
+    return b;
+}
+
+big_integer operator*(uint64_t a, big_integer b) {
+    b *= a;
+    return b;
+}
+
+big_integer operator*(uint32_t a, big_integer b) {
+    b *= a;
+    return b;
+}
+
+big_integer operator-(int a, big_integer b) {
+    b -= a;
+    b.sign = -b.sign;
+    return b;
+}
+
+big_integer operator-(int64_t a, big_integer b) {
+    b -= a;
+    b.sign = -b.sign;
+    return b;
+}
+
+big_integer operator-(uint64_t a, big_integer b) {
+    b -= a;
+    b.sign = -b.sign;
+    return b;
+}
+
+big_integer operator-(uint32_t a, big_integer b) {
+    b -= a;
+    b.sign = -b.sign;
+    return b;
+}
+
+big_integer operator&(big_integer a, big_integer const& b) {
+    a &= b;
+    return a;
+}
+
+big_integer operator&(big_integer const& a, big_integer&& b) {
+    return std::move(b &= a);
+}
+
+big_integer operator&(big_integer&& a, big_integer&& b) {
+    if (b.data.capacity() > a.data.capacity()) {
+        return std::move(b &= a);
+    }
+    return std::move(a &= b);
+}
+
+big_integer operator|(big_integer a, big_integer const& b) {
+    a |= b;
+    return a;
+}
+
+big_integer operator|(big_integer const& a, big_integer&& b) {
+    return std::move(b |= a);
+}
+
+big_integer operator|(big_integer&& a, big_integer&& b) {
+    if (b.data.capacity() > a.data.capacity()) {
+        return std::move(b |= a);
+    }
+    return std::move(a |= b);
+}
+
+big_integer operator^(big_integer a, big_integer const& b) {
+    a ^= b;
+    return a;
+}
+
+big_integer operator^(big_integer const& a, big_integer&& b) {
+    return std::move(b ^= a);
+}
+
+big_integer operator^(big_integer&& a, big_integer&& b) {
+    if (b.data.capacity() > a.data.capacity()) {
+        return std::move(b ^= a);
+    }
+    return std::move(a ^= b);
+}
+
+big_integer operator<<(big_integer a, int b) {
+    a <<= b;
+    return a;
+}
+
+big_integer operator>>(big_integer a, int b) {
+    a >>= b;
+    return a;
+}
+
+int32_t compare(big_integer const& a, big_integer const& b) {
+    if (a.sign != b.sign) {
+        return (a.sign < b.sign)? -1 : 1;
+    }
+    return compare_abs(a.data, b.data) * a.sign;
+}
+
+int32_t compare(big_integer const& a, int64_t b) {
+    int32_t b_sign = (b > 0) - (b < 0);
+    if (a.sign != b_sign) {
+        return (a.sign < b_sign)? -1 : 1;
+    }
+    uint64_t magnitude = (b < 0)? 0 - static_cast<uint64_t>(b) : static_cast<uint64_t>(b);
+    return compare_abs(a.data, magnitude) * a.sign;
+}
+
+int32_t compare(big_integer const& a, uint64_t b) {
+    if (a.sign < 0) {
+        return -1;
+    }
+    return compare_abs(a.data, b);
+}
+
+int32_t compare(big_integer const& a, int b) {
+    return compare(a, static_cast<int64_t>(b));
+}
+
+int32_t compare(big_integer const& a, uint32_t b) {
+    return compare(a, static_cast<uint64_t>(b));
+}
+
+bool operator==(big_integer const& a, big_integer const& b) {
+    return compare(a, b) == 0;
+}
+
+bool operator!=(big_integer const& a, big_integer const& b) {
+    return compare(a, b) != 0;
+}
+
+bool operator<(big_integer const& a, big_integer const& b) {
+    return compare(a, b) < 0;
+}
+
+bool operator>(big_integer const& a, big_integer const& b) {
+    return compare(a, b) > 0;
+}
+
+bool operator<=(big_integer const& a, big_integer const& b) {
+    return compare(a, b) <= 0;
+}
+
+bool operator>=(big_integer const& a, big_integer const& b) {
+    return compare(a, b) >= 0;
+}
+
+bool operator==(big_integer const& a, int b) {
+    return compare(a, b) == 0;
+}
+
+bool operator!=(big_integer const& a, int b) {
+    return compare(a, b) != 0;
+}
+
+bool operator<(big_integer const& a, int b) {
+    return compare(a, b) < 0;
+}
+
+bool operator>(big_integer const& a, int b) {
+    return compare(a, b) > 0;
+}
+
+bool operator<=(big_integer const& a, int b) {
+    return compare(a, b) <= 0;
+}
+
+bool operator>=(big_integer const& a, int b) {
+    return compare(a, b) >= 0;
+}
+
+bool operator==(int a, big_integer const& b) {
+    return compare(b, a) == 0;
+}
+
+bool operator!=(int a, big_integer const& b) {
+    return compare(b, a) != 0;
+}
+
+bool operator<(int a, big_integer const& b) {
+    return compare(b, a) > 0;
+}
+
+bool operator>(int a, big_integer const& b) {
+    return compare(b, a) < 0;
+}
+
+bool operator<=(int a, big_integer const& b) {
+    return compare(b, a) >= 0;
+}
+
+bool operator>=(int a, big_integer const& b) {
+    return compare(b, a) <= 0;
+}
+
+bool operator==(big_integer const& a, uint32_t b) {
+    return compare(a, b) == 0;
+}
+
+bool operator!=(big_integer const& a, uint32_t b) {
+    return compare(a, b) != 0;
+}
+
+bool operator<(big_integer const& a, uint32_t b) {
+    return compare(a, b) < 0;
+}
+
+bool operator>(big_integer const& a, uint32_t b) {
+    return compare(a, b) > 0;
+}
+
+bool operator<=(big_integer const& a, uint32_t b) {
+    return compare(a, b) <= 0;
+}
+
+bool operator>=(big_integer const& a, uint32_t b) {
+    return compare(a, b) >= 0;
+}
+
+bool operator==(uint32_t a, big_integer const& b) {
+    return compare(b, a) == 0;
+}
+
+bool operator!=(uint32_t a, big_integer const& b) {
+    return compare(b, a) != 0;
+}
+
+bool operator<(uint32_t a, big_integer const& b) {
+    return compare(b, a) > 0;
+}
+
+bool operator>(uint32_t a, big_integer const& b) {
+    return compare(b, a) < 0;
+}
+
+bool operator<=(uint32_t a, big_integer const& b) {
+    return compare(b, a) >= 0;
+}
+
+bool operator>=(uint32_t a, big_integer const& b) {
+    return compare(b, a) <= 0;
+}
+
+bool operator==(big_integer const& a, int64_t b) {
+    return compare(a, b) == 0;
+}
+
+bool operator!=(big_integer const& a, int64_t b) {
+    return compare(a, b) != 0;
+}
+
+bool operator<(big_integer const& a, int64_t b) {
+    return compare(a, b) < 0;
+}
+
+bool operator>(big_integer const& a, int64_t b) {
+    return compare(a, b) > 0;
+}
+
+bool operator<=(big_integer const& a, int64_t b) {
+    return compare(a, b) <= 0;
+}
+
+bool operator>=(big_integer const& a, int64_t b) {
+    return compare(a, b) >= 0;
+}
+
+bool operator==(int64_t a, big_integer const& b) {
+    return compare(b, a) == 0;
+}
+
+bool operator!=(int64_t a, big_integer const& b) {
+    return compare(b, a) != 0;
+}
+
+bool operator<(int64_t a, big_integer const& b) {
+    return compare(b, a) > 0;
+}
+
+bool operator>(int64_t a, big_integer const& b) {
+    return compare(b, a) < 0;
+}
+
+bool operator<=(int64_t a, big_integer const& b) {
+    return compare(b, a) >= 0;
+}
+
+bool operator>=(int64_t a, big_integer const& b) {
+    return compare(b, a) <= 0;
+}
+
+bool operator==(big_integer const& a, uint64_t b) {
+    return compare(a, b) == 0;
+}
+
+bool operator!=(big_integer const& a, uint64_t b) {
+    return compare(a, b) != 0;
+}
+
+bool operator<(big_integer const& a, uint64_t b) {
+    return compare(a, b) < 0;
+}
+
+bool operator>(big_integer const& a, uint64_t b) {
+    return compare(a, b) > 0;
+}
+
+bool operator<=(big_integer const& a, uint64_t b) {
+    return compare(a, b) <= 0;
+}
+
+bool operator>=(big_integer const& a, uint64_t b) {
+    return compare(a, b) >= 0;
+}
+
+bool operator==(uint64_t a, big_integer const& b) {
+    return compare(b, a) == 0;
+}
+
+bool operator!=(uint64_t a, big_integer const& b) {
+    return compare(b, a) != 0;
+}
+
+bool operator<(uint64_t a, big_integer const& b) {
+    return compare(b, a) > 0;
+}
+
+bool operator>(uint64_t a, big_integer const& b) {
+    return compare(b, a) < 0;
+}
+
+bool operator<=(uint64_t a, big_integer const& b) {
+    return compare(b, a) >= 0;
+}
+
+bool operator>=(uint64_t a, big_integer const& b) {
+    return compare(b, a) <= 0;
+}
+
+// powers[i] = 10 ^ (DECIMAL_DIGITS * 2^i) for i < level, where level is the least with DECIMAL_DIGITS * 2^level >= digits
+std::vector<big_integer> big_integer::decimal_powers(size_t digits) {
+    std::vector<big_integer> powers(1, big_integer(DECIMAL_BASE));
+    while ((DECIMAL_DIGITS << powers.size()) < digits) {
+        powers.push_back(powers.back() * powers.back());
+    }
+    return powers;
+}
+
+// parses digits < DECIMAL_DIGITS * 2^level decimal digits, splitting them by powers[level - 1]
+big_integer big_integer::from_decimal(char const* str, size_t digits, std::vector<big_integer> const& powers,
+                                      size_t level) {
+    if (level == 0 || digits <= FROM_STRING_THRESHOLD) {
+        data_storage words;
+        size_t chunk = digits - (digits - 1) / DECIMAL_DIGITS * DECIMAL_DIGITS;
+        word_t scale = 1;
+        for (size_t i = 0; i < chunk; ++i) {
+            scale *= 10;
+        }
+        for (char const* end = str + digits; str != end; str += chunk, chunk = DECIMAL_DIGITS) {
+            dword_t carry = 0;
+            for (size_t i = 0; i < chunk; ++i) {
+                carry = carry * 10 + static_cast<word_t>(str[i] - '0');
+            }
+            for (word_t& word : words) {
+                carry += static_cast<dword_t>(word) * scale;
+                word = static_cast<word_t>(carry);
+                carry >>= WORD_BITS;
+            }
+            if (carry != 0) {
+                words.push_back(static_cast<word_t>(carry));
+            }
+            scale = DECIMAL_BASE;
+        }
+        return words.empty() ? big_integer() : big_integer(words);
+    }
+    size_t low_digits = DECIMAL_DIGITS << (level - 1);
+    if (digits <= low_digits) {
+        return from_decimal(str, digits, powers, level - 1);
+    }
+    big_integer result = from_decimal(str, digits - low_digits, powers, level - 1);
+    result *= powers[level - 1];
+    result += from_decimal(str + digits - low_digits, low_digits, powers, level - 1);
+    return result;
+}
+
+// writes exactly `digits` decimal digits of value < 10 ^ (DECIMAL_DIGITS * 2^level) into out, most significant first
+void big_integer::to_decimal(char* out, big_integer const& value, std::vector<big_integer> const& powers,
+                             size_t level, size_t digits) {
+    if (level == 0 || value.size() <= TO_STRING_THRESHOLD) {
+        data_storage words(value.data);
+        char* end = out + digits;
+        while (!words.empty()) {
+            word_t rest = short_div(words, DECIMAL_BASE);
+            for (size_t i = 0; i < DECIMAL_DIGITS && end != out; ++i) {
+                *--end = static_cast<char>('0' + rest % 10);
+                rest /= 10;
+            }
+        }
+        std::fill(out, end, '0');
+        return;
+    }
+    size_t low_digits = DECIMAL_DIGITS << (level - 1);
+    big_integer const& power = powers[level - 1];
+    std::pair<big_integer, big_integer> parts = divmod(value, power);
+    to_decimal(out, parts.first, powers, level - 1, digits - low_digits);
+    to_decimal(out + digits - low_digits, parts.second, powers, level - 1, low_digits);
+}
+
+std::string to_string(big_integer const& a) {
+    if (a.sign == 0) {
+        return "0";
+    }
+    big_integer value(a);
+    value.sign = 1;
+    size_t level = 0;
+    size_t digits = (DECIMAL_DIGITS + 1) * value.size();
+    std::vector<big_integer> powers;
+    if (value.size() > TO_STRING_THRESHOLD) {
+        powers = big_integer::decimal_powers(digits);
+        level = powers.size();
+        digits = DECIMAL_DIGITS << level;
+    }
+
+    std::string result(digits, '0');
+    big_integer::to_decimal(&result[0], value, powers, level, result.size());
+    size_t start = result.find_first_not_of('0');
+    result.erase(0, start);
+    if (a.sign == -1) {
+        result.insert(result.begin(), '-');
+    }
+    return result;
+}
+
+big_integer &big_integer::operator=(big_integer const &other) {
+    data = other.data;
+    sign = other.sign;
+    return *this;
+}
+
+// other keeps the old buffer for reuse but, as after the move constructor, holds zero
+big_integer &big_integer::operator=(big_integer&& other) noexcept {
+    if (this != &other) {
+        data.swap(other.data);
+        sign = other.sign;
+        other.data.clear();
+        other.sign = 0;
+    }
     return *this;
 }
 
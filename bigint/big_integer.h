@@ -4,19 +4,39 @@
 #include <cstddef>
 #include <iosfwd>
 #include <cstdint>
+#include <string>
+#include <utility>
 #include <vector>
 #include <functional>
 
-struct big_integer {
-    using data_storage = std::vector<uint32_t>;
+#include "small_storage.h"
+
+#ifndef BIG_INTEGER_WORD_BITS
+#if defined(__x86_64__) && defined(__SIZEOF_INT128__)
+#define BIG_INTEGER_WORD_BITS 64
+#else
+#define BIG_INTEGER_WORD_BITS 32
+#endif
+#endif
+
+struct big_integer_divisor;
 
-    template<typename T>
-    using binary_operation = std::function<T(uint32_t, uint32_t)>;
+struct big_integer {
+#if BIG_INTEGER_WORD_BITS == 64
+    using word_t = uint64_t;
+#else
+    using word_t = uint32_t;
+#endif
+    using data_storage = small_storage<word_t, 2>;
 
     big_integer();
     big_integer(big_integer const& other);
+    big_integer(big_integer&& other) noexcept;
     big_integer(int a);
+    big_integer(word_t a);
+#if BIG_INTEGER_WORD_BITS == 64
     big_integer(uint32_t a);
+#endif
     explicit big_integer(std::string const& str);
     big_integer(int32_t sign, data_storage const& other_data);
     explicit big_integer(data_storage const& other);
@@ -24,12 +44,34 @@ struct big_integer {
     ~big_integer() = default;
 
     big_integer& operator=(big_integer const& other);
+    big_integer& operator=(big_integer&& other) noexcept;
     big_integer& operator+=(big_integer const& rhs);
     big_integer& operator-=(big_integer const& rhs);
     big_integer& operator*=(big_integer const& rhs);
     big_integer& operator/=(big_integer const& other);
     big_integer& operator%=(big_integer const& rhs);
 
+    big_integer& operator+=(int rhs);
+    big_integer& operator+=(int64_t rhs);
+    big_integer& operator+=(uint64_t rhs);
+    big_integer& operator+=(uint32_t rhs);
+    big_integer& operator-=(int rhs);
+    big_integer& operator-=(int64_t rhs);
+    big_integer& operator-=(uint64_t rhs);
+    big_integer& operator-=(uint32_t rhs);
+    big_integer& operator*=(int rhs);
+    big_integer& operator*=(int64_t rhs);
+    big_integer& operator*=(uint64_t rhs);
+    big_integer& operator*=(uint32_t rhs);
+    big_integer& operator/=(int rhs);
+    big_integer& operator/=(int64_t rhs);
+    big_integer& operator/=(uint64_t rhs);
+    big_integer& operator/=(uint32_t rhs);
+    big_integer& operator%=(int rhs);
+    big_integer& operator%=(int64_t rhs);
+    big_integer& operator%=(uint64_t rhs);
+    big_integer& operator%=(uint32_t rhs);
+
     big_integer& operator&=(big_integer const& rhs);
     big_integer& operator|=(big_integer const& rhs);
     big_integer& operator^=(big_integer const& rhs);
@@ -47,41 +89,216 @@ struct big_integer {
     big_integer& operator--();
     big_integer operator--(int);
 
-    friend bool operator==(big_integer const& a, big_integer const& b);
-    friend bool operator!=(big_integer const& a, big_integer const& b);
-    friend bool operator<(big_integer const& a, big_integer const& b);
-    friend bool operator>(big_integer const& a, big_integer const& b);
-    friend bool operator<=(big_integer const& a, big_integer const& b);
-    friend bool operator>=(big_integer const& a, big_integer const& b);
+    friend int32_t compare(big_integer const& a, big_integer const& b);
+    friend int32_t compare(big_integer const& a, int64_t b);
+    friend int32_t compare(big_integer const& a, uint64_t b);
+
+    friend big_integer operator+(big_integer&& a, big_integer&& b);
+    friend big_integer operator-(big_integer const& a, big_integer&& b);
+    friend big_integer operator-(big_integer&& a, big_integer&& b);
+    friend big_integer operator-(int a, big_integer b);
+    friend big_integer operator-(int64_t a, big_integer b);
+    friend big_integer operator-(uint64_t a, big_integer b);
+    friend big_integer operator-(uint32_t a, big_integer b);
+    friend big_integer operator*(big_integer&& a, big_integer&& b);
+    friend big_integer operator&(big_integer&& a, big_integer&& b);
+    friend big_integer operator|(big_integer&& a, big_integer&& b);
+    friend big_integer operator^(big_integer&& a, big_integer&& b);
 
     friend std::string to_string(big_integer const& a);
 
+    friend std::pair<big_integer, big_integer> divmod(big_integer const& a, big_integer const& b);
+    friend big_integer pow(big_integer const& base, uint64_t exponent);
+    friend big_integer pow_mod(big_integer const& base, big_integer const& exponent, big_integer const& modulus);
+    friend big_integer gcd(big_integer const& a, big_integer const& b);
+    friend big_integer extended_gcd(big_integer const& a, big_integer const& b, big_integer& x, big_integer& y);
+    friend big_integer iroot(big_integer const& a, uint64_t k);
+
+    friend struct big_integer_divisor;
+    friend struct big_integer_reciprocal;
+    friend struct big_integer_montgomery;
+    friend struct big_integer_barrett;
+
 private:
     data_storage data;
     int32_t sign;
 
-    big_integer& add_signed(int32_t rhs_sign, data_storage const& rhs_words);
-
-    uint32_t get_signed(size_t id, size_t not_zero_pos) const;
+    big_integer& add_signed(int32_t rhs_sign, word_t const* rhs_words, size_t n);
+    void mul_word(uint64_t rhs);
+    uint64_t div_word(uint64_t rhs);
+    void div_mod(big_integer const& other, big_integer& rest);
 
     size_t size() const;
 
-    big_integer &bit_operation(const big_integer &rhs, std::function<uint32_t(uint32_t, uint32_t)> const& op);
+    static big_integer high_words(big_integer const& a, size_t k);
+    static big_integer low_words(big_integer const& a, size_t k);
+    static data_storage residue(big_integer const& a, big_integer const& modulus, big_integer_divisor const& divisor);
+    static bool half_gcd(big_integer& a, big_integer& b, big_integer* cofactors);
+    static bool half_gcd_top(big_integer& a, big_integer& b, size_t k, big_integer* cofactors);
+    static bool gcd_reduce(big_integer& a, big_integer& b, size_t keep, big_integer* cofactors);
+
+    static std::vector<big_integer> decimal_powers(size_t digits);
+    static big_integer from_decimal(char const* str, size_t digits, std::vector<big_integer> const& powers,
+                                    size_t level);
+    static void to_decimal(char* out, big_integer const& value, std::vector<big_integer> const& powers,
+                           size_t level, size_t digits);
+
+    template<typename Op>
+    big_integer &bit_operation(const big_integer &rhs, Op op);
+};
+
+// Divides by a fixed divisor, keeping it normalized together with the reciprocal of its top limb,
+// so that each quotient limb is estimated with multiplications instead of a hardware division
+struct big_integer_divisor {
+    explicit big_integer_divisor(big_integer const& value);
+
+    big_integer divide(big_integer const& a) const;
+    std::pair<big_integer, big_integer> divmod(big_integer const& a) const;
+
+private:
+    big_integer::data_storage divisor;
+    big_integer::word_t inverse;
+    size_t shift;
+    int32_t sign;
+
+    void div_mod(big_integer& a, big_integer& rest) const;
+
+    friend struct big_integer;
+};
+
+// Divides by a fixed large divisor with two multiplications per divisor-sized block of the dividend,
+// using floor(BASE^(2m) / d) for the normalized m-limb divisor d, computed once by Newton iteration
+struct big_integer_reciprocal {
+    explicit big_integer_reciprocal(big_integer const& value);
+
+    big_integer divide(big_integer const& a) const;
+    std::pair<big_integer, big_integer> divmod(big_integer const& a) const;
+
+private:
+    big_integer divisor;
+    big_integer inverse;
+    size_t shift;
+    int32_t sign;
+
+    static big_integer power_of_base(size_t k);
+    static big_integer shl_words(big_integer a, size_t k);
+    static big_integer reciprocal_of(big_integer const& v);
+};
+
+// Modular arithmetic for a fixed odd modulus of n limbs: residues are kept as n-limb spans in Montgomery
+// form x * BASE^n and products are reduced with REDC, which needs no division
+struct big_integer_montgomery {
+    explicit big_integer_montgomery(big_integer const& value);
+
+    big_integer mul_mod(big_integer const& a, big_integer const& b) const;
+    big_integer sqr_mod(big_integer const& a) const;
+    big_integer pow_mod(big_integer const& base, big_integer const& exponent) const;
+
+private:
+    big_integer_divisor divisor;
+    big_integer modulus;
+    big_integer::data_storage r2;
+    big_integer::word_t inverse;
+
+    big_integer::data_storage residue(big_integer const& a) const;
+    void mul(big_integer::word_t* res, big_integer::word_t const* a, big_integer::word_t const* b,
+             big_integer::word_t* work) const;
+    void sqr(big_integer::word_t* res, big_integer::word_t const* a, big_integer::word_t* work) const;
+};
+
+// Modular arithmetic for any positive modulus of n limbs: products are reduced with two multiplications
+// by the precomputed mu = floor(BASE^(2n) / modulus) and at most a few subtractions
+struct big_integer_barrett {
+    explicit big_integer_barrett(big_integer const& value);
+
+    big_integer mul_mod(big_integer const& a, big_integer const& b) const;
+    big_integer sqr_mod(big_integer const& a) const;
+    big_integer pow_mod(big_integer const& base, big_integer const& exponent) const;
+
+private:
+    big_integer_divisor divisor;
+    big_integer modulus;
+    big_integer::data_storage padded;
+    big_integer::data_storage mu;
+
+    big_integer::data_storage residue(big_integer const& a) const;
+    void mul(big_integer::word_t* res, big_integer::word_t const* a, big_integer::word_t const* b,
+             big_integer::word_t* work) const;
+    void sqr(big_integer::word_t* res, big_integer::word_t const* a, big_integer::word_t* work) const;
 };
 
 big_integer operator+(big_integer a, big_integer const& b);
+big_integer operator+(big_integer const& a, big_integer&& b);
+big_integer operator+(big_integer&& a, big_integer&& b);
 big_integer operator-(big_integer a, big_integer const& b);
+big_integer operator-(big_integer const& a, big_integer&& b);
+big_integer operator-(big_integer&& a, big_integer&& b);
 big_integer operator*(big_integer a, big_integer const& b);
+big_integer operator*(big_integer const& a, big_integer&& b);
+big_integer operator*(big_integer&& a, big_integer&& b);
 big_integer operator/(big_integer a, big_integer const& b);
 big_integer operator%(big_integer a, big_integer const& b);
+big_integer operator+(big_integer a, int b);
+big_integer operator+(big_integer a, int64_t b);
+big_integer operator+(big_integer a, uint64_t b);
+big_integer operator+(big_integer a, uint32_t b);
+big_integer operator+(int a, big_integer b);
+big_integer operator+(int64_t a, big_integer b);
+big_integer operator+(uint64_t a, big_integer b);
+big_integer operator+(uint32_t a, big_integer b);
+big_integer operator-(big_integer a, int b);
+big_integer operator-(big_integer a, int64_t b);
+big_integer operator-(big_integer a, uint64_t b);
+big_integer operator-(big_integer a, uint32_t b);
+big_integer operator-(int a, big_integer b);
+big_integer operator-(int64_t a, big_integer b);
+big_integer operator-(uint64_t a, big_integer b);
+big_integer operator-(uint32_t a, big_integer b);
+big_integer operator*(big_integer a, int b);
+big_integer operator*(big_integer a, int64_t b);
+big_integer operator*(big_integer a, uint64_t b);
+big_integer operator*(big_integer a, uint32_t b);
+big_integer operator*(int a, big_integer b);
+big_integer operator*(int64_t a, big_integer b);
+big_integer operator*(uint64_t a, big_integer b);
+big_integer operator*(uint32_t a, big_integer b);
+big_integer operator/(big_integer a, int b);
+big_integer operator/(big_integer a, int64_t b);
+big_integer operator/(big_integer a, uint64_t b);
+big_integer operator/(big_integer a, uint32_t b);
+big_integer operator%(big_integer a, int b);
+big_integer operator%(big_integer a, int64_t b);
+big_integer operator%(big_integer a, uint64_t b);
+big_integer operator%(big_integer a, uint32_t b);
+std::pair<big_integer, big_integer> divmod(big_integer const& a, big_integer const& b);
+big_integer pow(big_integer const& base, uint64_t exponent);
+big_integer pow_mod(big_integer const& base, big_integer const& exponent, big_integer const& modulus);
+big_integer gcd(big_integer const& a, big_integer const& b);
+big_integer lcm(big_integer const& a, big_integer const& b);
+big_integer extended_gcd(big_integer const& a, big_integer const& b, big_integer& x, big_integer& y);
+big_integer isqrt(big_integer const& a);
+big_integer iroot(big_integer const& a, uint64_t k);
 
 big_integer operator&(big_integer a, big_integer const& b);
+big_integer operator&(big_integer const& a, big_integer&& b);
+big_integer operator&(big_integer&& a, big_integer&& b);
 big_integer operator|(big_integer a, big_integer const& b);
+big_integer operator|(big_integer const& a, big_integer&& b);
+big_integer operator|(big_integer&& a, big_integer&& b);
 big_integer operator^(big_integer a, big_integer const& b);
+big_integer operator^(big_integer const& a, big_integer&& b);
+big_integer operator^(big_integer&& a, big_integer&& b);
 
 big_integer operator<<(big_integer a, int b);
 big_integer operator>>(big_integer a, int b);
 
+// Three-way comparison: negative, zero or positive as a is less than, equal to or greater than b
+int32_t compare(big_integer const& a, big_integer const& b);
+int32_t compare(big_integer const& a, int b);
+int32_t compare(big_integer const& a, uint32_t b);
+int32_t compare(big_integer const& a, int64_t b);
+int32_t compare(big_integer const& a, uint64_t b);
+
 bool operator==(big_integer const& a, big_integer const& b);
 bool operator!=(big_integer const& a, big_integer const& b);
 bool operator<(big_integer const& a, big_integer const& b);
@@ -89,6 +306,58 @@ bool operator>(big_integer const& a, big_integer const& b);
 bool operator<=(big_integer const& a, big_integer const& b);
 bool operator>=(big_integer const& a, big_integer const& b);
 
+bool operator==(big_integer const& a, int b);
+bool operator!=(big_integer const& a, int b);
+bool operator<(big_integer const& a, int b);
+bool operator>(big_integer const& a, int b);
+bool operator<=(big_integer const& a, int b);
+bool operator>=(big_integer const& a, int b);
+bool operator==(int a, big_integer const& b);
+bool operator!=(int a, big_integer const& b);
+bool operator<(int a, big_integer const& b);
+bool operator>(int a, big_integer const& b);
+bool operator<=(int a, big_integer const& b);
+bool operator>=(int a, big_integer const& b);
+
+bool operator==(big_integer const& a, uint32_t b);
+bool operator!=(big_integer const& a, uint32_t b);
+bool operator<(big_integer const& a, uint32_t b);
+bool operator>(big_integer const& a, uint32_t b);
+bool operator<=(big_integer const& a, uint32_t b);
+bool operator>=(big_integer const& a, uint32_t b);
+bool operator==(uint32_t a, big_integer const& b);
+bool operator!=(uint32_t a, big_integer const& b);
+bool operator<(uint32_t a, big_integer const& b);
+bool operator>(uint32_t a, big_integer const& b);
+bool operator<=(uint32_t a, big_integer const& b);
+bool operator>=(uint32_t a, big_integer const& b);
+
+bool operator==(big_integer const& a, int64_t b);
+bool operator!=(big_integer const& a, int64_t b);
+bool operator<(big_integer const& a, int64_t b);
+bool operator>(big_integer const& a, int64_t b);
+bool operator<=(big_integer const& a, int64_t b);
+bool operator>=(big_integer const& a, int64_t b);
+bool operator==(int64_t a, big_integer const& b);
+bool operator!=(int64_t a, big_integer const& b);
+bool operator<(int64_t a, big_integer const& b);
+bool operator>(int64_t a, big_integer const& b);
+bool operator<=(int64_t a, big_integer const& b);
+bool operator>=(int64_t a, big_integer const& b);
+
+bool operator==(big_integer const& a, uint64_t b);
+bool operator!=(big_integer const& a, uint64_t b);
+bool operator<(big_integer const& a, uint64_t b);
+bool operator>(big_integer const& a, uint64_t b);
+bool operator<=(big_integer const& a, uint64_t b);
+bool operator>=(big_integer const& a, uint64_t b);
+bool operator==(uint64_t a, big_integer const& b);
+bool operator!=(uint64_t a, big_integer const& b);
+bool operator<(uint64_t a, big_integer const& b);
+bool operator>(uint64_t a, big_integer const& b);
+bool operator<=(uint64_t a, big_integer const& b);
+bool operator>=(uint64_t a, big_integer const& b);
+
 std::string to_string(big_integer const& a);
 std::ostream& operator<<(std::ostream& s, big_integer const& a);
 
@@ -0,0 +1,93 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+
+#include "big_integer.h"
+
+static std::mt19937 rng(12345);
+
+static big_integer rand_big(size_t digits, bool negative) {
+    std::string str(negative? "-" : "");
+    str += static_cast<char>('1' + rng() % 9);
+    for (size_t i = 1; i < digits; ++i) {
+        str += static_cast<char>('0' + rng() % 10);
+    }
+    return big_integer(str);
+}
+
+template<typename F>
+static void run(char const* name, size_t digits, size_t repeats, F f) {
+    big_integer a = rand_big(digits, false);
+    big_integer b = rand_big(digits, true);
+    big_integer sink;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < repeats; ++i) {
+        sink = f(a, b);
+    }
+    auto finish = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(finish - start).count() / repeats;
+    std::printf("%-3s %7zu digits: %12.1f ns/op%s\n", name, digits, ns, sink == 0? " (zero)" : "");
+}
+
+int main() {
+    size_t const sizes[] = {100, 1000, 10000, 100000};
+    for (size_t digits : sizes) {
+        size_t repeats = 20000000 / digits;
+        run("+", digits, repeats, [](big_integer const& a, big_integer const& b) { return a + a; });
+        run("-", digits, repeats, [](big_integer const& a, big_integer const& b) { return a + b; });
+        run("&", digits, repeats, [](big_integer const& a, big_integer const& b) { return a & b; });
+        run("|", digits, repeats, [](big_integer const& a, big_integer const& b) { return a | b; });
+        run("^", digits, repeats, [](big_integer const& a, big_integer const& b) { return a ^ b; });
+        run("<<", digits, repeats, [](big_integer const& a, big_integer const& b) { return a << 37; });
+        run(">>", digits, repeats, [](big_integer const& a, big_integer const& b) { return b >> 37; });
+        run("*w", digits, repeats, [](big_integer const& a, big_integer const& b) { return a * 1000000007; });
+        run("/w", digits, repeats, [](big_integer const& a, big_integer const& b) { return b / 1000000007; });
+        run("+-", digits, repeats, [](big_integer const& a, big_integer const& b) { return a + a - b + a - b; });
+    }
+    for (size_t digits : sizes) {
+        size_t terms = 100000000 / digits;
+        run("sum", digits, 1, [terms](big_integer const& a, big_integer const& b) {
+            big_integer acc;
+            for (size_t i = 0; i < terms; ++i) {
+                acc += a;
+                acc += b;
+            }
+            return acc;
+        });
+    }
+    for (size_t digits : sizes) {
+        size_t repeats = std::max<size_t>(1, 2000000000 / (digits * digits));
+        big_integer dividend = rand_big(2 * digits, false);
+        run("/", digits, repeats, [&dividend](big_integer const& a, big_integer const& b) { return dividend / b; });
+    }
+    size_t const modulus_digits[] = {617, 1234, 2467};
+    for (size_t digits : modulus_digits) {
+        big_integer modulus = rand_big(digits, false) * 2 + 1;
+        big_integer exponent = rand_big(digits, false);
+        big_integer_montgomery montgomery(modulus);
+        big_integer_barrett barrett(modulus);
+        run("%", digits, 1, [&](big_integer const& a, big_integer const&) {
+            big_integer res = 1;
+            big_integer base = a % modulus;
+            for (int i = static_cast<int>(digits * 4); i >= 0; --i) {
+                res = res * res % modulus;
+                if (((exponent >> i) & 1) != 0) {
+                    res = res * base % modulus;
+                }
+            }
+            return res;
+        });
+        run("mon", digits, 1, [&](big_integer const& a, big_integer const&) {
+            return montgomery.pow_mod(a, exponent);
+        });
+        run("bar", digits, 1, [&](big_integer const& a, big_integer const&) {
+            return barrett.pow_mod(a, exponent);
+        });
+        run("pow", digits, 1, [&](big_integer const& a, big_integer const&) {
+            return pow(a, 64);
+        });
+    }
+    return 0;
+}
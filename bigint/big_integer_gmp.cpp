@@ -183,6 +183,31 @@ bool operator>=(big_integer_gmp const& a, big_integer_gmp const& b) {
   return mpz_cmp(a.mpz, b.mpz) >= 0;
 }
 
+big_integer_gmp pow_mod(big_integer_gmp const& base, big_integer_gmp const& exponent,
+                        big_integer_gmp const& modulus) {
+  big_integer_gmp res;
+  mpz_powm(res.mpz, base.mpz, exponent.mpz, modulus.mpz);
+  return res;
+}
+
+big_integer_gmp gcd(big_integer_gmp const& a, big_integer_gmp const& b) {
+  big_integer_gmp res;
+  mpz_gcd(res.mpz, a.mpz, b.mpz);
+  return res;
+}
+
+big_integer_gmp lcm(big_integer_gmp const& a, big_integer_gmp const& b) {
+  big_integer_gmp res;
+  mpz_lcm(res.mpz, a.mpz, b.mpz);
+  return res;
+}
+
+big_integer_gmp iroot(big_integer_gmp const& a, unsigned long k) {
+  big_integer_gmp res;
+  mpz_root(res.mpz, a.mpz, k);
+  return res;
+}
+
 std::string to_string(big_integer_gmp const& a) {
   char* tmp = mpz_get_str(NULL, 10, a.mpz);
   std::string res = tmp;
@@ -59,6 +59,11 @@ struct big_integer_gmp {
   friend bool operator>=(big_integer_gmp const& a, big_integer_gmp const& b);
 
   friend std::string to_string(big_integer_gmp const& a);
+  friend big_integer_gmp pow_mod(big_integer_gmp const& base, big_integer_gmp const& exponent,
+                                 big_integer_gmp const& modulus);
+  friend big_integer_gmp gcd(big_integer_gmp const& a, big_integer_gmp const& b);
+  friend big_integer_gmp lcm(big_integer_gmp const& a, big_integer_gmp const& b);
+  friend big_integer_gmp iroot(big_integer_gmp const& a, unsigned long k);
 
  private:
   mpz_t mpz;
@@ -84,6 +89,12 @@ bool operator>(big_integer_gmp const& a, big_integer_gmp const& b);
 bool operator<=(big_integer_gmp const& a, big_integer_gmp const& b);
 bool operator>=(big_integer_gmp const& a, big_integer_gmp const& b);
 
+big_integer_gmp pow_mod(big_integer_gmp const& base, big_integer_gmp const& exponent,
+                        big_integer_gmp const& modulus);
+big_integer_gmp gcd(big_integer_gmp const& a, big_integer_gmp const& b);
+big_integer_gmp lcm(big_integer_gmp const& a, big_integer_gmp const& b);
+big_integer_gmp iroot(big_integer_gmp const& a, unsigned long k);
+
 std::string to_string(big_integer_gmp const& a);
 std::ostream& operator<<(std::ostream& s, big_integer_gmp const& a);
 
@@ -28,6 +28,13 @@ TEST(correctness, ctor_limits) {
   EXPECT_EQ(-1, a + b);
 }
 
+TEST(correctness, ctor_unsigned) {
+  big_integer a(5u);
+  big_integer b = std::numeric_limits<uint32_t>::max();
+  EXPECT_EQ("5", to_string(a));
+  EXPECT_EQ("4294967295", to_string(b));
+}
+
 TEST(correctness, copy_ctor) {
   big_integer a = 3;
   big_integer b = a;
@@ -76,6 +83,83 @@ TEST(correctness, assignment_return_value) {
   EXPECT_TRUE(b == 7);
 }
 
+TEST(correctness, move_ctor_and_assignment) {
+  big_integer a("123456789012345678901234567890");
+  big_integer b = std::move(a);
+  EXPECT_EQ(b, big_integer("123456789012345678901234567890"));
+
+  big_integer c = 5;
+  c = std::move(b);
+  EXPECT_EQ(c, big_integer("123456789012345678901234567890"));
+  EXPECT_EQ(0, b);
+
+  a = 7;
+  EXPECT_EQ(7, a);
+}
+
+TEST(correctness, rvalue_operators) {
+  big_integer a("1000000000000000000000000000000");
+  big_integer b("-999999999999999999999999999999");
+
+  EXPECT_EQ(1, a + big_integer(b));
+  EXPECT_EQ(1, big_integer(a) + big_integer(b));
+  EXPECT_EQ(big_integer("1999999999999999999999999999999"), a - big_integer(b));
+  EXPECT_EQ(big_integer("-1999999999999999999999999999999"), b - big_integer(a));
+  EXPECT_EQ(big_integer("1999999999999999999999999999999"), big_integer(a) - big_integer(b));
+  EXPECT_EQ(big_integer("-1999999999999999999999999999999"), big_integer(b) - big_integer(a));
+  EXPECT_EQ(a * b, big_integer(a) * big_integer(b));
+  EXPECT_EQ(a * b, a * big_integer(b));
+  EXPECT_EQ(a & b, a & big_integer(b));
+  EXPECT_EQ(a | b, big_integer(a) | big_integer(b));
+  EXPECT_EQ(a ^ b, a ^ big_integer(b));
+  EXPECT_EQ(a + a, a + big_integer(a));
+  EXPECT_EQ(0, a - big_integer(a));
+  EXPECT_EQ(-b, 0 - big_integer(b));
+}
+
+TEST(correctness, data_storage_inline_and_heap) {
+  using storage = big_integer::data_storage;
+  storage a;
+  a.push_back(1);
+  a.push_back(2);
+  EXPECT_EQ(2u, a.capacity());
+  storage b = a;
+  b.push_back(3);
+  EXPECT_LT(2u, b.capacity());
+  EXPECT_EQ(2u, a.size());
+  EXPECT_EQ(3u, b.back());
+
+  b.swap(a);
+  EXPECT_EQ(3u, a.size());
+  EXPECT_EQ(2u, b.size());
+  EXPECT_EQ(2u, b.capacity());
+  EXPECT_EQ(1u, a[0]);
+  EXPECT_EQ(3u, a[2]);
+
+  storage c(std::move(a));
+  EXPECT_TRUE(a.empty());
+  EXPECT_EQ(2u, a.capacity());
+  c.insert(c.begin(), 2, 0U);
+  EXPECT_EQ(5u, c.size());
+  EXPECT_EQ(0u, c[1]);
+  EXPECT_EQ(1u, c[2]);
+  c.assign(c.begin() + 2, c.end());
+  EXPECT_EQ(3u, c.size());
+  EXPECT_EQ(1u, c[0]);
+
+  storage d(c.begin(), c.end());
+  EXPECT_TRUE(c == d);
+  d.resize(6);
+  EXPECT_EQ(0u, d.back());
+  d = b;
+  EXPECT_TRUE(d == b);
+  d.assign(4, 7U);
+  EXPECT_EQ(7u, d[3]);
+  b = std::move(d);
+  EXPECT_EQ(4u, b.size());
+  EXPECT_TRUE(d.empty());
+}
+
 TEST(correctness, comparisons) {
   big_integer a = 100;
   big_integer b = 100;
@@ -100,6 +184,47 @@ TEST(correctness, compare_zero_and_minus_zero) {
   EXPECT_TRUE(a == b);
 }
 
+TEST(correctness, compare_machine_words) {
+  int64_t const values[] = {INT64_MIN, INT64_MIN + 1, -4294967297LL, -4294967296LL, -4294967295LL, INT32_MIN,
+                            -1, 0, 1, INT32_MAX, 4294967295LL, 4294967296LL, 4294967297LL, INT64_MAX};
+  for (int64_t x : values) {
+    big_integer a(std::to_string(x));
+    EXPECT_EQ(0, compare(a, x));
+    for (int64_t y : values) {
+      big_integer b(std::to_string(y));
+      int32_t expected = (x < y) ? -1 : (x > y);
+      EXPECT_EQ(expected, compare(a, b));
+      EXPECT_EQ(expected, compare(a, y));
+      EXPECT_EQ(x == y, a == y);
+      EXPECT_EQ(x != y, a != y);
+      EXPECT_EQ(x < y, a < y);
+      EXPECT_EQ(x > y, a > y);
+      EXPECT_EQ(x <= y, a <= y);
+      EXPECT_EQ(x >= y, a >= y);
+      EXPECT_EQ(x < y, x < b);
+      EXPECT_EQ(x >= y, x >= b);
+    }
+  }
+
+  big_integer max_u64("18446744073709551615");
+  EXPECT_TRUE(max_u64 == UINT64_MAX);
+  EXPECT_TRUE(max_u64 + 1 > UINT64_MAX);
+  EXPECT_TRUE(max_u64 - 1 < UINT64_MAX);
+  EXPECT_TRUE(big_integer(-1) < UINT64_MAX);
+  EXPECT_TRUE(max_u64 > INT64_MAX);
+  EXPECT_TRUE(-max_u64 < INT64_MIN);
+  EXPECT_TRUE(5 < big_integer(6));
+  EXPECT_TRUE(big_integer(-7) <= -7);
+
+  big_integer max_u32("4294967295");
+  EXPECT_EQ(0, compare(max_u32, 4294967295u));
+  EXPECT_TRUE(max_u32 == 4294967295u);
+  EXPECT_TRUE(max_u32 + 1 > 4294967295u);
+  EXPECT_TRUE(big_integer(-1) < 0u);
+  EXPECT_TRUE(5u <= big_integer(5));
+  EXPECT_TRUE(5u != big_integer(-5));
+}
+
 TEST(correctness, add) {
   big_integer a = 5;
   big_integer b = 20;
@@ -198,6 +323,11 @@ TEST(correctness, div_) {
 
   c %= b;
   EXPECT_TRUE(c == 0);
+
+  big_integer z;
+  EXPECT_THROW(z %= z, std::runtime_error);
+  a %= a;
+  EXPECT_EQ(0, a);
 }
 
 TEST(correctness, div_int_min) {
@@ -241,6 +371,29 @@ TEST(correctness, div_rounding_negative) {
   EXPECT_TRUE(c % d == -3);
 }
 
+TEST(correctness, divmod) {
+  std::pair<big_integer, big_integer> r = divmod(-23, 5);
+  EXPECT_EQ(-4, r.first);
+  EXPECT_EQ(-3, r.second);
+
+  big_integer a("-100000000000000000000000000000000000000000000000000000000000000000007");
+  big_integer b("10000000000000000000000000000000000");
+  r = divmod(a, b);
+  EXPECT_EQ(big_integer("-10000000000000000000000000000000000"), r.first);
+  EXPECT_EQ(-7, r.second);
+
+  r = divmod(b, a);
+  EXPECT_EQ(0, r.first);
+  EXPECT_EQ(b, r.second);
+
+  r = divmod(a, a);
+  EXPECT_EQ(1, r.first);
+  EXPECT_EQ(0, r.second);
+
+  a %= a;
+  EXPECT_EQ(0, a);
+}
+
 TEST(correctness, div_return_value) {
   big_integer a = 100;
   big_integer b = 2;
@@ -293,6 +446,28 @@ TEST(correctness, decrement)
     EXPECT_EQ(41, post);
 }
 
+TEST(correctness, increment_decrement_word_boundaries) {
+  big_integer a("18446744073709551615");
+  ++a;
+  EXPECT_EQ("18446744073709551616", to_string(a));
+  --a;
+  EXPECT_EQ("18446744073709551615", to_string(a));
+  big_integer b("-18446744073709551616");
+  ++b;
+  EXPECT_EQ("-18446744073709551615", to_string(b));
+  --b;
+  EXPECT_EQ("-18446744073709551616", to_string(b));
+
+  big_integer c = -1;
+  ++c;
+  EXPECT_EQ(0, c);
+  ++c;
+  EXPECT_EQ(1, c);
+  --c;
+  --c;
+  EXPECT_EQ(-1, c);
+}
+
 TEST(correctness, and_) {
   big_integer a = 0x55;
   big_integer b = 0xaa;
@@ -469,6 +644,25 @@ TEST(correctness, sub_long) {
   EXPECT_EQ(c, a - b);
 }
 
+TEST(correctness, add_sub_long_in_place) {
+  big_integer a = (big_integer(1) << 256) - 1;
+  big_integer b = 1;
+  big_integer c = -(big_integer(1) << 512);
+
+  a += b;
+  EXPECT_EQ(big_integer(1) << 256, a);
+  a += a;
+  EXPECT_EQ(big_integer(1) << 257, a);
+  b -= a;
+  EXPECT_EQ(1 - (big_integer(1) << 257), b);
+  a -= c;
+  EXPECT_EQ((big_integer(1) << 512) + (big_integer(1) << 257), a);
+  c += a;
+  EXPECT_EQ(big_integer(1) << 257, c);
+  c -= c;
+  EXPECT_EQ(0, c);
+}
+
 TEST(correctness, mul_long) {
   big_integer a("10000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000");
   big_integer b("100000000000000000000000000000000000000");
@@ -566,6 +760,12 @@ TEST(correctness, string_conv) {
   EXPECT_EQ("0", to_string(big_integer("0")));
   EXPECT_EQ("0", to_string(big_integer("-0")));
   EXPECT_EQ("-1000000000000000", to_string(big_integer("-1000000000000000")));
+  EXPECT_EQ("0", to_string(big_integer("000")));
+  EXPECT_EQ("-7", to_string(big_integer("  -7")));
+  EXPECT_THROW(big_integer("  "), std::runtime_error);
+  EXPECT_THROW(big_integer(" -"), std::runtime_error);
+  EXPECT_THROW(big_integer("+"), std::runtime_error);
+  EXPECT_THROW(big_integer("-+1"), std::runtime_error);
 
   big_integer lim = std::numeric_limits<int32_t>::max();
   EXPECT_EQ("2147483647", to_string(lim));
@@ -776,6 +976,57 @@ TEST(correctness_random, mod) {
   }
 }
 
+TEST(correctness_random, machine_word_operands) {
+  std::default_random_engine rng(57);
+  uint64_t const edges[] = {1, 2, 3, 4294967295ULL, 4294967296ULL, 4294967297ULL, 9223372036854775807ULL,
+                            9223372036854775808ULL, 18446744073709551615ULL};
+  for (size_t itn = 0; itn != number_of_iterations; ++itn) {
+    big_integer_gmp a;
+    a.random(itn % 4 == 0 ? 2 : max_size, rng);
+    uint64_t u = (itn % 2 == 0) ? edges[rng() % 9] : (static_cast<uint64_t>(rng()) << 32U) ^ rng();
+    if (u == 0) {
+      u = 1;
+    }
+    int64_t s = static_cast<int64_t>(u);
+    int i = static_cast<int>(rng()) | 1;
+    uint32_t w = static_cast<uint32_t>(rng()) | 1U;
+    big_integer_gmp gu(std::to_string(u)), gs(std::to_string(s)), gi(i), gw(std::to_string(w));
+    big_integer A(to_string(a));
+
+    EXPECT_EQ(to_string(a + gu), to_string(A + u));
+    EXPECT_EQ(to_string(a - gu), to_string(A - u));
+    EXPECT_EQ(to_string(gu - a), to_string(u - A));
+    EXPECT_EQ(to_string(a * gu), to_string(A * u));
+    EXPECT_EQ(to_string(a / gu), to_string(A / u));
+    EXPECT_EQ(to_string(a % gu), to_string(A % u));
+
+    EXPECT_EQ(to_string(a + gs), to_string(A + s));
+    EXPECT_EQ(to_string(gs - a), to_string(s - A));
+    EXPECT_EQ(to_string(gs * a), to_string(s * A));
+    EXPECT_EQ(to_string(a / gs), to_string(A / s));
+    EXPECT_EQ(to_string(a % gs), to_string(A % s));
+
+    EXPECT_EQ(to_string(a - gi), to_string(A - i));
+    EXPECT_EQ(to_string(a * gi), to_string(A * i));
+    EXPECT_EQ(to_string(a / gi), to_string(A / i));
+    EXPECT_EQ(to_string(a % gi), to_string(A % i));
+
+    EXPECT_EQ(to_string(a + gw), to_string(A + w));
+    EXPECT_EQ(to_string(gw - a), to_string(w - A));
+    EXPECT_EQ(to_string(gw * a), to_string(w * A));
+    EXPECT_EQ(to_string(a / gw), to_string(A / w));
+    EXPECT_EQ(to_string(a % gw), to_string(A % w));
+
+    big_integer B = A;
+    B += s;
+    B *= u;
+    B -= i;
+    B += 5u;
+    B *= 3u;
+    EXPECT_EQ(to_string(((a + gs) * gu - gi + 5) * 3), to_string(B));
+  }
+}
+
 TEST(correctness_random, bitwise) {
   std::default_random_engine rng(42);
   for (size_t itn = 0; itn != number_of_iterations; ++itn) {
@@ -809,6 +1060,44 @@ TEST(correctness_random, bit_shifts) {
   }
 }
 
+TEST(correctness, bit_shifts_word_boundaries) {
+  std::string const values[] = {"-340282366920938463463374607431768211456", "-340282366920938463463374607431768211455",
+                                "340282366920938463463374607431768211455", "-1", "-18446744073709551617"};
+  for (std::string const& value : values) {
+    big_integer_gmp a(value);
+    big_integer b(value);
+    for (int shift = 0; shift <= 200; ++shift) {
+      EXPECT_EQ(to_string(a << shift), to_string(b << shift));
+      EXPECT_EQ(to_string(a >> shift), to_string(b >> shift));
+    }
+  }
+  EXPECT_EQ(-1, big_integer(-5) >> 1000);
+  EXPECT_EQ(0, big_integer(5) >> 1000);
+  EXPECT_EQ(-20, big_integer(-5) >> -2);
+}
+
+TEST(correctness, bit_operations_word_boundaries) {
+  std::string const values[] = {"0", "-1", "1", "-18446744073709551616", "-18446744073709551615", "18446744073709551615",
+                                "-340282366920938463463374607431768211456", "-4294967296", "4294967295"};
+  for (std::string const& x : values) {
+    big_integer_gmp a(x);
+    big_integer A(x);
+    EXPECT_EQ(to_string(~a), to_string(~A));
+    for (std::string const& y : values) {
+      big_integer_gmp b(y);
+      big_integer B(y);
+      EXPECT_EQ(to_string(a & b), to_string(A & B));
+      EXPECT_EQ(to_string(a | b), to_string(A | B));
+      EXPECT_EQ(to_string(a ^ b), to_string(A ^ B));
+    }
+    big_integer C = A;
+    C &= C;
+    EXPECT_EQ(A, C);
+    C ^= C;
+    EXPECT_EQ(0, C);
+  }
+}
+
 // TODO: extend due to idea
 TEST(correctness_twos_complement, simple) {
   std::string a = "-36893488147419103232"; // -(1 << 65)
@@ -835,3 +1124,447 @@ TEST(correctness_twos_complement, all_ones) {
 
   EXPECT_EQ(to_string(gmp_ans), to_string(your_ans));
 }
+
+TEST(correctness_random, mul_long) {
+  std::default_random_engine rng(42);
+  for (size_t itn = 0; itn != number_of_iterations; ++itn) {
+    big_integer_gmp a, b;
+    a.random(max_size * 8, rng);
+    b.random(max_size * (itn + 1), rng);
+    big_integer_gmp c = a * b;
+    big_integer R = big_integer(to_string(a)) * big_integer(to_string(b));
+    EXPECT_EQ(to_string(c), to_string(R));
+  }
+}
+
+TEST(correctness_random, mul_toom3) {
+  std::default_random_engine rng(322);
+  for (size_t itn = 0; itn != number_of_iterations / 2; ++itn) {
+    big_integer_gmp a, b;
+    a.random(max_size * 16, rng);
+    b.random(max_size * (12 + itn), rng);
+    big_integer_gmp c = a * b;
+    big_integer R = big_integer(to_string(a)) * big_integer(to_string(b));
+    EXPECT_EQ(to_string(c), to_string(R));
+  }
+}
+
+TEST(correctness, mul_ntt) {
+  int const bits = 200000;
+  big_integer ones = (big_integer(1) << bits) - 1;
+  EXPECT_EQ(ones * ones, (big_integer(1) << (2 * bits)) - (big_integer(1) << (bits + 1)) + 1);
+
+  big_integer a = rand_big(6400);
+  big_integer b = rand_big(6200);
+  big_integer hi = b >> 64000;
+  big_integer lo = b - (hi << 64000);
+  EXPECT_EQ(a * b, ((a * hi) << 64000) + a * lo);
+}
+
+TEST(correctness_random, sqr) {
+  std::default_random_engine rng(42);
+  for (size_t itn = 0; itn != number_of_iterations; ++itn) {
+    big_integer_gmp a;
+    a.random(32 << itn, rng);
+    big_integer_gmp c = a * a;
+    big_integer A = big_integer(to_string(a));
+    EXPECT_EQ(to_string(c), to_string(A * A));
+    A *= A;
+    EXPECT_EQ(to_string(c), to_string(A));
+  }
+}
+
+TEST(correctness, string_conv_long) {
+  big_integer_gmp a_gmp(7), ten_gmp(1);
+  big_integer a(7), ten(1);
+  for (size_t i = 0; i != 16; ++i) {
+    a_gmp *= a_gmp;
+    a *= a;
+  }
+  for (size_t i = 0; i != 20000; ++i) {
+    ten_gmp *= 10;
+    ten *= 10;
+  }
+  EXPECT_EQ(to_string(a_gmp), to_string(a));
+  EXPECT_EQ(to_string(-a_gmp), to_string(-a));
+  EXPECT_EQ(to_string(ten_gmp), to_string(ten));
+  EXPECT_EQ(to_string(ten_gmp - 1), to_string(ten - 1));
+  EXPECT_EQ(to_string(a_gmp * ten_gmp), to_string(a * ten));
+}
+
+TEST(correctness, div_quotient_correction) {
+  big_integer b = 1;
+  for (size_t i = 0; i != 72; ++i)
+    b *= 10;
+  big_integer a = b * b - 1;
+  EXPECT_EQ(b - 1, a / b);
+  EXPECT_EQ(b - 1, a % b);
+}
+
+TEST(correctness_random, string_conv_long) {
+  std::default_random_engine rng(42);
+  for (size_t itn = 0; itn != 8; ++itn) {
+    big_integer_gmp a;
+    a.random(max_size << itn, rng);
+    EXPECT_EQ(to_string(a), to_string(big_integer(to_string(a))));
+  }
+}
+
+TEST(correctness_random, mul_ntt) {
+  std::default_random_engine rng(42);
+  big_integer_gmp a, b;
+  a.random(176000, rng);
+  b.random(180000, rng);
+  big_integer_gmp c = a * b;
+  big_integer R = big_integer(to_string(a)) * big_integer(to_string(b));
+  EXPECT_EQ(to_string(c), to_string(R));
+}
+
+big_integer_gmp rand_extreme_gmp(size_t chunks, std::default_random_engine& rng) {
+  int const patterns[] = {0, 1, 0x7fff, 0x8000, 0xffff};
+  big_integer_gmp x = 1;
+  for (size_t i = 0; i != chunks; ++i) {
+    x <<= 16;
+    x += (rng() % 2 == 0) ? patterns[rng() % 5] : static_cast<int>(rng() % 0x10000);
+  }
+  return x;
+}
+
+TEST(correctness_random, div_extreme_limbs) {
+  std::default_random_engine rng(7);
+  for (size_t itn = 0; itn != 1000; ++itn) {
+    big_integer_gmp a = rand_extreme_gmp(8 + rng() % 24, rng);
+    big_integer_gmp b = rand_extreme_gmp(4 + rng() % 8, rng);
+    big_integer A(to_string(a));
+    big_integer B(to_string(b));
+    EXPECT_EQ(to_string(a / b), to_string(A / B));
+    EXPECT_EQ(to_string(a % b), to_string(A % B));
+  }
+}
+
+TEST(correctness_random, div_long_divisor) {
+  std::default_random_engine rng(13);
+  for (size_t itn = 0; itn != 40; ++itn) {
+    big_integer_gmp a, b;
+    size_t divisor_bits = 2000 + rng() % 100000;
+    a.random(divisor_bits + rng() % 200000, rng);
+    b.random(divisor_bits, rng);
+    big_integer A(to_string(a));
+    big_integer B(to_string(b));
+    EXPECT_EQ(to_string(a / b), to_string(A / B));
+    EXPECT_EQ(to_string(a % b), to_string(A % B));
+  }
+  for (size_t itn = 0; itn != 40; ++itn) {
+    big_integer_gmp a = rand_extreme_gmp(300 + rng() % 3000, rng);
+    big_integer_gmp b = rand_extreme_gmp(200 + rng() % 600, rng);
+    big_integer A(to_string(a));
+    big_integer B(to_string(b));
+    EXPECT_EQ(to_string(a / b), to_string(A / B));
+    EXPECT_EQ(to_string(a % b), to_string(A % B));
+  }
+}
+
+TEST(correctness_random, reciprocal_divide) {
+  std::default_random_engine rng(21);
+  for (size_t itn = 0; itn != 12; ++itn) {
+    big_integer_gmp b;
+    size_t divisor_bits = 2000 + rng() % 100000;
+    b.random(divisor_bits, rng);
+    big_integer_reciprocal R(big_integer(to_string(b)));
+    for (size_t i = 0; i != 4; ++i) {
+      big_integer_gmp a;
+      a.random(rng() % (4 * divisor_bits), rng);
+      std::pair<big_integer, big_integer> r = R.divmod(big_integer(to_string(a)));
+      EXPECT_EQ(to_string(a / b), to_string(r.first));
+      EXPECT_EQ(to_string(a % b), to_string(r.second));
+    }
+  }
+  for (size_t itn = 0; itn != 12; ++itn) {
+    big_integer_gmp a = rand_extreme_gmp(3000 + rng() % 6000, rng);
+    big_integer_gmp b = rand_extreme_gmp(1000 + rng() % 2000, rng);
+    big_integer_reciprocal R(big_integer(to_string(b)));
+    EXPECT_EQ(to_string(a / b), to_string(R.divide(big_integer(to_string(a)))));
+  }
+}
+
+TEST(correctness_random, div_newton) {
+  std::default_random_engine rng(42);
+  big_integer_gmp a, b;
+  a.random(2200000, rng);
+  b.random(700000, rng);
+  big_integer A(to_string(a));
+  big_integer B(to_string(b));
+  EXPECT_EQ(to_string(a / b), to_string(A / B));
+  EXPECT_EQ(to_string(a % b), to_string(A % B));
+}
+
+TEST(correctness_random, divmod) {
+  std::default_random_engine rng(5);
+  for (size_t itn = 0; itn != 60; ++itn) {
+    big_integer_gmp a, b;
+    a.random(rng() % (16 * max_size), rng);
+    b.random(1 + rng() % (8 * max_size), rng);
+    if (b == 0) {
+      continue;
+    }
+    std::pair<big_integer, big_integer> r = divmod(big_integer(to_string(a)), big_integer(to_string(b)));
+    EXPECT_EQ(to_string(a / b), to_string(r.first));
+    EXPECT_EQ(to_string(a % b), to_string(r.second));
+  }
+}
+
+TEST(correctness_random, invariant_divisor) {
+  std::default_random_engine rng(17);
+  for (size_t itn = 0; itn != 40; ++itn) {
+    big_integer_gmp b;
+    b.random(1 + rng() % (itn < 20 ? 64 : 8 * max_size), rng);
+    if (b == 0) {
+      continue;
+    }
+    big_integer_divisor D(big_integer(to_string(b)));
+    for (size_t i = 0; i != 5; ++i) {
+      big_integer_gmp a;
+      a.random(rng() % (16 * max_size), rng);
+      std::pair<big_integer, big_integer> r = D.divmod(big_integer(to_string(a)));
+      EXPECT_EQ(to_string(a / b), to_string(r.first));
+      EXPECT_EQ(to_string(a % b), to_string(r.second));
+      EXPECT_EQ(to_string(a / b), to_string(D.divide(big_integer(to_string(a)))));
+    }
+  }
+}
+
+big_integer_gmp rand_modulus(size_t bits, std::default_random_engine& rng, bool odd) {
+  big_integer_gmp m;
+  m.random(bits, rng);
+  if (m < 0) {
+    m = -m;
+  }
+  if (odd && m % 2 == 0) {
+    m += 1;
+  }
+  if (m == 0) {
+    m = 1;
+  }
+  return m;
+}
+
+big_integer_gmp mod_positive(big_integer_gmp const& a, big_integer_gmp const& m) {
+  return ((a % m) + m) % m;
+}
+
+TEST(correctness_random, montgomery) {
+  std::default_random_engine rng(11);
+  for (size_t itn = 0; itn != 12; ++itn) {
+    big_integer_gmp m = rand_modulus(itn < 4 ? 1 + rng() % 200 : 2048 << (itn % 3), rng, true);
+    big_integer_montgomery ctx(big_integer(to_string(m)));
+    big_integer_gmp a, b, e;
+    a.random(2 * 8192, rng);
+    b.random(1 + rng() % 8192, rng);
+    e.random(1 + rng() % 1024, rng);
+    if (e < 0) {
+      e = -e;
+    }
+    big_integer A(to_string(a));
+    big_integer B(to_string(b));
+    EXPECT_EQ(to_string(mod_positive(a * b, m)), to_string(ctx.mul_mod(A, B)));
+    EXPECT_EQ(to_string(mod_positive(b * b, m)), to_string(ctx.sqr_mod(B)));
+    EXPECT_EQ(to_string(pow_mod(a, e, m)), to_string(ctx.pow_mod(A, big_integer(to_string(e)))));
+    EXPECT_EQ(to_string(pow_mod(b, 0, m)), to_string(ctx.pow_mod(B, 0)));
+  }
+}
+
+TEST(correctness_random, barrett) {
+  std::default_random_engine rng(12);
+  for (size_t itn = 0; itn != 12; ++itn) {
+    big_integer_gmp m = rand_modulus(itn < 4 ? 1 + rng() % 200 : 2048 << (itn % 3), rng, false);
+    big_integer_barrett ctx(big_integer(to_string(m)));
+    big_integer_gmp a, b, e;
+    a.random(2 * 8192, rng);
+    b.random(1 + rng() % 8192, rng);
+    e.random(1 + rng() % 1024, rng);
+    if (e < 0) {
+      e = -e;
+    }
+    big_integer A(to_string(a));
+    big_integer B(to_string(b));
+    EXPECT_EQ(to_string(mod_positive(a * b, m)), to_string(ctx.mul_mod(A, B)));
+    EXPECT_EQ(to_string(mod_positive(b * b, m)), to_string(ctx.sqr_mod(B)));
+    EXPECT_EQ(to_string(pow_mod(a, e, m)), to_string(ctx.pow_mod(A, big_integer(to_string(e)))));
+  }
+}
+
+TEST(correctness, modular_context_edge_cases) {
+  big_integer_barrett one(1);
+  EXPECT_EQ(0, one.pow_mod(5, 3));
+  EXPECT_EQ(0, big_integer_montgomery(1).pow_mod(5, 0));
+
+  big_integer power = big_integer(1) << 128;
+  big_integer_barrett ctx(power);
+  big_integer a = (big_integer(1) << 127) + 12345;
+  EXPECT_EQ((a * a) % power, ctx.sqr_mod(a));
+  EXPECT_EQ(power - 1, ctx.mul_mod(-1, 1));
+
+  big_integer_montgomery odd(big_integer("1000000007"));
+  EXPECT_EQ(1, odd.pow_mod(3, big_integer("1000000006")));
+  EXPECT_EQ(big_integer("1000000006"), odd.mul_mod(-1, 1));
+}
+
+TEST(correctness, pow) {
+  EXPECT_EQ(1, pow(big_integer(0), 0));
+  EXPECT_EQ(0, pow(big_integer(0), 7));
+  EXPECT_EQ(-1, pow(big_integer(-1), 3));
+  EXPECT_EQ(1, pow(big_integer(-1), 4));
+  EXPECT_EQ(big_integer(1) << 100, pow(big_integer(2), 100));
+  EXPECT_EQ(big_integer("1000000000000000000000000000000"), pow(big_integer(-10), 30));
+  EXPECT_EQ(big_integer("-1000000000000000000000000000000000"), pow(big_integer(-10), 33));
+  EXPECT_EQ(big_integer("515377520732011331036461129765621272702107522001"), pow(big_integer(3), 100));
+
+  EXPECT_EQ(1, pow_mod(big_integer(3), big_integer("1000000006"), big_integer("-1000000007")));
+  EXPECT_EQ(24, pow_mod(big_integer(-2), 3, 32));
+  EXPECT_EQ(0, pow_mod(big_integer(7), 3, 1));
+  EXPECT_THROW(pow_mod(big_integer(2), 3, 0), std::runtime_error);
+  EXPECT_THROW(pow(big_integer(2), 4294967296ULL), std::runtime_error);
+  EXPECT_THROW(pow(big_integer(-4), 2147483648ULL), std::runtime_error);
+  EXPECT_THROW(pow(big_integer(2), 18446744073709551615ULL), std::runtime_error);
+}
+
+TEST(correctness, gcd) {
+  EXPECT_EQ(0, gcd(big_integer(0), 0));
+  EXPECT_EQ(7, gcd(big_integer(0), -7));
+  EXPECT_EQ(6, gcd(big_integer(-12), 18));
+  EXPECT_EQ(12, lcm(big_integer(-4), 6));
+  EXPECT_EQ(0, lcm(big_integer(0), 5));
+
+  big_integer x, y;
+  EXPECT_EQ(2, extended_gcd(240, 46, x, y));
+  EXPECT_EQ(-9, x);
+  EXPECT_EQ(47, y);
+  EXPECT_EQ(5, extended_gcd(-5, 0, x, y));
+  EXPECT_EQ(-1, x);
+  EXPECT_EQ(0, y);
+  EXPECT_EQ(5, extended_gcd(0, -5, x, y));
+  EXPECT_EQ(0, x);
+  EXPECT_EQ(-1, y);
+  EXPECT_EQ(0, extended_gcd(0, 0, x, y));
+  EXPECT_EQ(0, x);
+  EXPECT_EQ(0, y);
+
+  x = -240;
+  y = 46;
+  EXPECT_EQ(2, extended_gcd(x, y, x, y));
+  EXPECT_EQ(9, x);
+  EXPECT_EQ(47, y);
+}
+
+TEST(correctness_random, gcd) {
+  std::default_random_engine rng(15);
+  for (size_t itn = 0; itn != 40; ++itn) {
+    size_t bits = itn < 20 ? 1 + rng() % 2000 : 20000 + rng() % 40000;
+    big_integer_gmp a, b, c;
+    a.random(bits, rng);
+    b.random(itn % 4 == 0 ? 1 + rng() % bits : bits, rng);
+    c.random(1 + rng() % (bits / 2 + 1), rng);
+    a *= c;
+    b *= c;
+    big_integer A(to_string(a));
+    big_integer B(to_string(b));
+    EXPECT_EQ(to_string(gcd(a, b)), to_string(gcd(A, B)));
+    EXPECT_EQ(to_string(lcm(a, b)), to_string(lcm(A, B)));
+  }
+}
+
+TEST(correctness_random, extended_gcd) {
+  std::default_random_engine rng(16);
+  for (size_t itn = 0; itn != 30; ++itn) {
+    size_t bits = itn < 15 ? 1 + rng() % 2000 : 20000 + rng() % 30000;
+    big_integer_gmp a, b, c;
+    a.random(bits, rng);
+    b.random(itn % 3 == 0 ? 1 + rng() % bits : bits, rng);
+    c.random(1 + rng() % (bits / 2 + 1), rng);
+    a *= c;
+    b *= c;
+    big_integer A(to_string(a));
+    big_integer B(to_string(b));
+    big_integer x, y;
+    big_integer g = extended_gcd(A, B, x, y);
+    EXPECT_EQ(to_string(gcd(a, b)), to_string(g));
+    EXPECT_EQ(g, A * x + B * y);
+    big_integer twice_x = 2 * g * x;
+    EXPECT_LE(twice_x < 0 ? -twice_x : twice_x, B < 0 ? -B : B);
+
+    big_integer alias_a = A;
+    big_integer alias_b = B;
+    EXPECT_EQ(g, extended_gcd(alias_a, alias_b, alias_a, alias_b));
+    EXPECT_EQ(x, alias_a);
+    EXPECT_EQ(y, alias_b);
+  }
+}
+
+TEST(correctness, iroot) {
+  EXPECT_EQ(0, isqrt(big_integer(0)));
+  EXPECT_EQ(3, isqrt(big_integer(15)));
+  EXPECT_EQ(4, isqrt(big_integer(16)));
+  EXPECT_EQ(-3, iroot(big_integer(-27), 3));
+  EXPECT_EQ(-2, iroot(big_integer(-26), 3));
+  EXPECT_EQ(1, iroot(big_integer(1), 5));
+  EXPECT_EQ(1, iroot(big_integer(7), 100));
+  EXPECT_EQ(big_integer(1) << 100, isqrt(big_integer(1) << 200));
+  EXPECT_EQ((big_integer(1) << 100) - 1, isqrt((big_integer(1) << 200) - 1));
+  EXPECT_THROW(isqrt(-1), std::runtime_error);
+  EXPECT_THROW(iroot(big_integer(-4), 2), std::runtime_error);
+  EXPECT_THROW(iroot(big_integer(5), 0), std::runtime_error);
+}
+
+TEST(correctness_random, iroot) {
+  std::default_random_engine rng(17);
+  unsigned long const degrees[] = {2, 3, 5, 7, 64};
+  for (size_t itn = 0; itn != 40; ++itn) {
+    unsigned long k = degrees[itn % 5];
+    big_integer_gmp a;
+    a.random(itn < 20 ? 1 + rng() % 500 : 1 + rng() % 50000, rng);
+    if (a < 0) {
+      a = -a;
+    }
+    if (itn % 3 == 0) {
+      big_integer_gmp r = iroot(a, k);
+      big_integer_gmp power = 1;
+      for (unsigned long i = 0; i != k; ++i) {
+        power *= r;
+      }
+      a = power - (itn % 2);
+    }
+    big_integer A(to_string(a));
+    EXPECT_EQ(to_string(iroot(a, k)), to_string(iroot(A, k)));
+    EXPECT_EQ(to_string(iroot(-a, 3)), to_string(iroot(-A, 3)));
+  }
+}
+
+TEST(correctness_random, pow) {
+  std::default_random_engine rng(13);
+  for (size_t itn = 0; itn != 20; ++itn) {
+    big_integer_gmp a;
+    a.random(1 + rng() % 300, rng);
+    a *= big_integer_gmp(1) << static_cast<int>(rng() % 100);
+    uint64_t e = rng() % 200;
+    big_integer_gmp expected = 1;
+    for (uint64_t i = 0; i != e; ++i) {
+      expected *= a;
+    }
+    EXPECT_EQ(to_string(expected), to_string(pow(big_integer(to_string(a)), e)));
+  }
+}
+
+TEST(correctness_random, pow_mod) {
+  std::default_random_engine rng(14);
+  for (size_t itn = 0; itn != 16; ++itn) {
+    big_integer_gmp m = rand_modulus(itn < 4 ? 1 + rng() % 200 : 1024 << (itn % 3), rng, itn % 2 == 0);
+    big_integer_gmp a, e;
+    a.random(1 + rng() % 4096, rng);
+    e.random(1 + rng() % 2048, rng);
+    if (e < 0) {
+      e = -e;
+    }
+    EXPECT_EQ(to_string(pow_mod(a, e, m)),
+              to_string(pow_mod(big_integer(to_string(a)), big_integer(to_string(e)), big_integer(to_string(m)))));
+  }
+}
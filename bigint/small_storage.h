@@ -0,0 +1,321 @@
+#ifndef SMALL_STORAGE_H
+#define SMALL_STORAGE_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// A vector of trivially copyable elements that keeps up to N of them inside the object
+// and only allocates once it grows past that; the heap buffer is kept until destruction
+template <typename T, size_t N>
+struct small_storage {
+    static_assert(std::is_trivially_copyable<T>::value, "small_storage needs trivially copyable elements");
+    static_assert(N != 0, "small_storage needs room for at least one element inline");
+
+    typedef T value_type;
+    typedef T* iterator;
+    typedef T const* const_iterator;
+
+    small_storage();                                          // O(1) nothrow
+    explicit small_storage(size_t n);                         // O(N) strong, zero-filled
+    small_storage(T const* first, T const* last);             // O(N) strong
+    small_storage(small_storage const& other);                // O(N) strong
+    small_storage(small_storage&& other) noexcept;            // O(1) nothrow
+    small_storage& operator=(small_storage const& other);     // O(N) strong
+    small_storage& operator=(small_storage&& other) noexcept; // O(1) nothrow
+
+    ~small_storage();                                         // O(1) nothrow
+
+    T& operator[](size_t i);                                  // O(1) nothrow
+    T const& operator[](size_t i) const;                      // O(1) nothrow
+
+    T* data();                                                // O(1) nothrow
+    T const* data() const;                                    // O(1) nothrow
+    size_t size() const;                                      // O(1) nothrow
+    size_t capacity() const;                                  // O(1) nothrow
+    bool empty() const;                                       // O(1) nothrow
+
+    T& back();                                                // O(1) nothrow
+    T const& back() const;                                    // O(1) nothrow
+
+    iterator begin();                                         // O(1) nothrow
+    iterator end();                                           // O(1) nothrow
+    const_iterator begin() const;                             // O(1) nothrow
+    const_iterator end() const;                               // O(1) nothrow
+
+    void push_back(T const& value);                           // O(1)* strong
+    void pop_back();                                          // O(1) nothrow
+    void clear();                                             // O(1) nothrow
+    void resize(size_t n);                                    // O(N) strong, zero-fills new elements
+    void reserve(size_t n);                                   // O(N) strong
+    void assign(T const* first, T const* last);               // O(N) strong
+    void assign(size_t n, T const& value);                    // O(N) strong
+    iterator insert(const_iterator pos, size_t count, T const& value); // O(N) strong
+
+    void swap(small_storage& other) noexcept;                 // O(1) nothrow
+
+private:
+    bool is_inline() const;
+    void reallocate(size_t new_capacity);
+
+    // holds no pointers into the object itself, so it is copied and swapped as plain bytes
+    union buffer {
+        T inline_[N];
+        T* heap_;
+    };
+
+    size_t size_;
+    size_t capacity_;
+    buffer buffer_;
+};
+
+template <typename T, size_t N>
+bool operator==(small_storage<T, N> const& a, small_storage<T, N> const& b) {
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+}
+
+template <typename T, size_t N>
+bool operator!=(small_storage<T, N> const& a, small_storage<T, N> const& b) {
+    return !(a == b);
+}
+
+template <typename T, size_t N>
+small_storage<T, N>::small_storage() : size_(0), capacity_(N) {
+    buffer_.heap_ = nullptr;
+}
+
+template <typename T, size_t N>
+small_storage<T, N>::small_storage(size_t n) : small_storage() {
+    resize(n);
+}
+
+template <typename T, size_t N>
+small_storage<T, N>::small_storage(T const* first, T const* last) : small_storage() {
+    assign(first, last);
+}
+
+template <typename T, size_t N>
+small_storage<T, N>::small_storage(small_storage const& other) : size_(other.size_), capacity_(N) {
+    if (other.is_inline()) {
+        buffer_ = other.buffer_;
+    } else {
+        buffer_.heap_ = nullptr;
+        size_ = 0;
+        assign(other.begin(), other.end());
+    }
+}
+
+template <typename T, size_t N>
+small_storage<T, N>::small_storage(small_storage&& other) noexcept
+        : size_(other.size_), capacity_(other.capacity_), buffer_(other.buffer_) {
+    other.size_ = 0;
+    other.capacity_ = N;
+}
+
+template <typename T, size_t N>
+small_storage<T, N>& small_storage<T, N>::operator=(small_storage const& other) {
+    if (this != &other) {
+        if (is_inline() && other.is_inline()) {
+            buffer_ = other.buffer_;
+            size_ = other.size_;
+        } else {
+            assign(other.begin(), other.end());
+        }
+    }
+    return *this;
+}
+
+template <typename T, size_t N>
+small_storage<T, N>& small_storage<T, N>::operator=(small_storage&& other) noexcept {
+    if (this != &other) {
+        if (!is_inline()) {
+            operator delete(buffer_.heap_);
+        }
+        size_ = other.size_;
+        capacity_ = other.capacity_;
+        buffer_ = other.buffer_;
+        other.size_ = 0;
+        other.capacity_ = N;
+    }
+    return *this;
+}
+
+template <typename T, size_t N>
+small_storage<T, N>::~small_storage() {
+    if (!is_inline()) {
+        operator delete(buffer_.heap_);
+    }
+}
+
+template <typename T, size_t N>
+bool small_storage<T, N>::is_inline() const {
+    return capacity_ == N;
+}
+
+template <typename T, size_t N>
+void small_storage<T, N>::reallocate(size_t new_capacity) {
+    T* new_data = static_cast<T*>(operator new(new_capacity * sizeof(T)));
+    std::copy(data(), data() + size_, new_data);
+    if (!is_inline()) {
+        operator delete(buffer_.heap_);
+    }
+    buffer_.heap_ = new_data;
+    capacity_ = new_capacity;
+}
+
+template <typename T, size_t N>
+T& small_storage<T, N>::operator[](size_t i) {
+    assert(i < size_);
+    return data()[i];
+}
+
+template <typename T, size_t N>
+T const& small_storage<T, N>::operator[](size_t i) const {
+    assert(i < size_);
+    return data()[i];
+}
+
+template <typename T, size_t N>
+T* small_storage<T, N>::data() {
+    return is_inline() ? buffer_.inline_ : buffer_.heap_;
+}
+
+template <typename T, size_t N>
+T const* small_storage<T, N>::data() const {
+    return is_inline() ? buffer_.inline_ : buffer_.heap_;
+}
+
+template <typename T, size_t N>
+size_t small_storage<T, N>::size() const {
+    return size_;
+}
+
+template <typename T, size_t N>
+size_t small_storage<T, N>::capacity() const {
+    return capacity_;
+}
+
+template <typename T, size_t N>
+bool small_storage<T, N>::empty() const {
+    return size_ == 0;
+}
+
+template <typename T, size_t N>
+T& small_storage<T, N>::back() {
+    assert(size_ != 0);
+    return data()[size_ - 1];
+}
+
+template <typename T, size_t N>
+T const& small_storage<T, N>::back() const {
+    assert(size_ != 0);
+    return data()[size_ - 1];
+}
+
+template <typename T, size_t N>
+typename small_storage<T, N>::iterator small_storage<T, N>::begin() {
+    return data();
+}
+
+template <typename T, size_t N>
+typename small_storage<T, N>::iterator small_storage<T, N>::end() {
+    return data() + size_;
+}
+
+template <typename T, size_t N>
+typename small_storage<T, N>::const_iterator small_storage<T, N>::begin() const {
+    return data();
+}
+
+template <typename T, size_t N>
+typename small_storage<T, N>::const_iterator small_storage<T, N>::end() const {
+    return data() + size_;
+}
+
+template <typename T, size_t N>
+void small_storage<T, N>::push_back(T const& value) {
+    if (size_ == capacity_) {
+        T copy = value;
+        reallocate(2 * capacity_);
+        data()[size_++] = copy;
+    } else {
+        data()[size_++] = value;
+    }
+}
+
+template <typename T, size_t N>
+void small_storage<T, N>::pop_back() {
+    assert(size_ != 0);
+    --size_;
+}
+
+template <typename T, size_t N>
+void small_storage<T, N>::clear() {
+    size_ = 0;
+}
+
+template <typename T, size_t N>
+void small_storage<T, N>::resize(size_t n) {
+    if (n > capacity_) {
+        reallocate(std::max(n, 2 * size_));
+    }
+    if (n > size_) {
+        std::fill(data() + size_, data() + n, T());
+    }
+    size_ = n;
+}
+
+template <typename T, size_t N>
+void small_storage<T, N>::reserve(size_t n) {
+    if (n > capacity_) {
+        reallocate(n);
+    }
+}
+
+// first may point into this storage, the elements are only moved towards the front then
+template <typename T, size_t N>
+void small_storage<T, N>::assign(T const* first, T const* last) {
+    size_t n = static_cast<size_t>(last - first);
+    if (n > capacity_) {
+        small_storage copy;
+        copy.reallocate(n);
+        std::copy(first, last, copy.buffer_.heap_);
+        copy.size_ = n;
+        *this = std::move(copy);
+        return;
+    }
+    std::copy(first, last, data());
+    size_ = n;
+}
+
+template <typename T, size_t N>
+void small_storage<T, N>::assign(size_t n, T const& value) {
+    T copy = value;
+    clear();
+    resize(n);
+    std::fill(data(), data() + n, copy);
+}
+
+template <typename T, size_t N>
+typename small_storage<T, N>::iterator small_storage<T, N>::insert(const_iterator pos, size_t count, T const& value) {
+    size_t offset = static_cast<size_t>(pos - begin());
+    size_t old_size = size_;
+    T copy = value;
+    resize(size_ + count);
+    T* words = data();
+    std::copy_backward(words + offset, words + old_size, words + size_);
+    std::fill(words + offset, words + offset + count, copy);
+    return words + offset;
+}
+
+template <typename T, size_t N>
+void small_storage<T, N>::swap(small_storage& other) noexcept {
+    std::swap(size_, other.size_);
+    std::swap(capacity_, other.capacity_);
+    std::swap(buffer_, other.buffer_);
+}
+
+#endif // SMALL_STORAGE_H